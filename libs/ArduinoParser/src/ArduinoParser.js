@@ -2474,6 +2474,10 @@ class Parser {
                     type: 'NumberNode', 
                     value: token.value
                 };
+                // 2.0 and 2 are the same JavaScript number; keep the C type of the constant
+                if (token.type === 'FLOAT_NUMBER') {
+                    node.isFloat = true;
+                }
                 // Add position info only if requested (for backwards compatibility)
                 if (this.options.includePositions) {
                     node.line = token.line;
@@ -367,6 +367,10 @@ ASTNodePtr CompactASTReader::parseNode(size_t nodeIndex) {
             DEBUG_OUT << "parseNode(" << nodeIndex << "): Creating CommaExpression" << std::endl;
             node = std::make_unique<CommaExpression>();
             break;
+        case ASTNodeType::NEW_EXPRESSION:
+            DEBUG_OUT << "parseNode(" << nodeIndex << "): Creating NewExpressionNode" << std::endl;
+            node = std::make_unique<NewExpressionNode>();
+            break;
             
         // Literals and identifiers
         case ASTNodeType::NUMBER_LITERAL:
@@ -445,6 +449,11 @@ ASTNodePtr CompactASTReader::parseNode(size_t nodeIndex) {
         DEBUG_OUT << "parseNode(" << nodeIndex << "): Parsing value..." << std::endl;
         ASTValue value = parseValue();
         node->setValue(value);
+        
+        // The value is read back as a double either way; the encoding tells 2 from 2.0
+        if (auto* number = dynamic_cast<NumberNode*>(node.get())) {
+            number->setInteger(lastValueType_ != ValueType::FLOAT32_VAL && lastValueType_ != ValueType::FLOAT64_VAL);
+        }
         DEBUG_OUT << "parseNode(" << nodeIndex << "): Value parsed" << std::endl;
     }
     
@@ -482,6 +491,7 @@ ASTValue CompactASTReader::parseValue() {
     validatePosition(1);
     uint8_t valueTypeRaw = readUint8();
     ValueType valueType = static_cast<ValueType>(valueTypeRaw);
+    lastValueType_ = valueType;
     
     DEBUG_OUT << "parseValue(): valueType = " << static_cast<int>(valueType) << std::endl;
     
@@ -626,6 +636,9 @@ void CompactASTReader::linkNodeChildren() {
                     } else if (childType == ASTNodeType::DECLARATOR_NODE && !funcDefNode->getDeclarator()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting declarator" << std::endl;
                         funcDefNode->setDeclarator(std::move(nodes_[childIndex]));
+                    } else if (childType == ASTNodeType::PARAM_NODE) {
+                        DEBUG_OUT << "linkNodeChildren(): Adding parameter" << std::endl;
+                        funcDefNode->addParameter(std::move(nodes_[childIndex]));
                     } else if (childType == ASTNodeType::COMPOUND_STMT && !funcDefNode->getBody()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting body" << std::endl;
                         funcDefNode->setBody(std::move(nodes_[childIndex]));
@@ -636,6 +649,26 @@ void CompactASTReader::linkNodeChildren() {
                 } else {
                     parentNode->addChild(std::move(nodes_[childIndex]));
                 }
+            } else if (parentNode->getType() == ASTNodeType::PARAM_NODE) {
+                auto* paramNode = dynamic_cast<arduino_ast::ParamNode*>(parentNode.get());
+                if (paramNode) {
+                    // Children come as paramType, declarator, defaultValue; the default stays a generic child
+                    auto childType = childNodeRef->getType();
+                    if (childType == ASTNodeType::TYPE_NODE && !paramNode->getParamType()) {
+                        DEBUG_OUT << "linkNodeChildren(): Setting parameter type" << std::endl;
+                        paramNode->setParamType(std::move(nodes_[childIndex]));
+                    } else if ((childType == ASTNodeType::DECLARATOR_NODE ||
+                                childType == ASTNodeType::ARRAY_DECLARATOR ||
+                                childType == ASTNodeType::POINTER_DECLARATOR ||
+                                childType == ASTNodeType::FUNCTION_POINTER_DECLARATOR) && !paramNode->getDeclarator()) {
+                        DEBUG_OUT << "linkNodeChildren(): Setting parameter declarator" << std::endl;
+                        paramNode->setDeclarator(std::move(nodes_[childIndex]));
+                    } else {
+                        parentNode->addChild(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
             } else if (parentNode->getType() == ASTNodeType::VAR_DECL) {
                 auto* varDeclNode = dynamic_cast<arduino_ast::VarDeclNode*>(parentNode.get());
                 if (varDeclNode) {
@@ -645,8 +678,9 @@ void CompactASTReader::linkNodeChildren() {
                     if (childType == ASTNodeType::TYPE_NODE && !varDeclNode->getVarType()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting var type" << std::endl;
                         varDeclNode->setVarType(std::move(nodes_[childIndex]));
-                    } else if (childType == ASTNodeType::DECLARATOR_NODE) {
-                        DEBUG_OUT << "linkNodeChildren(): Adding DeclaratorNode to declarations" << std::endl;
+                    } else if (childType == ASTNodeType::DECLARATOR_NODE ||
+                               childType == ASTNodeType::ARRAY_DECLARATOR) {
+                        DEBUG_OUT << "linkNodeChildren(): Adding declarator to declarations" << std::endl;
                         varDeclNode->addDeclaration(std::move(nodes_[childIndex]));
                     } else if (childType == ASTNodeType::NUMBER_LITERAL || 
                                childType == ASTNodeType::STRING_LITERAL ||
@@ -656,6 +690,7 @@ void CompactASTReader::linkNodeChildren() {
                                childType == ASTNodeType::BINARY_OP ||
                                childType == ASTNodeType::UNARY_OP ||
                                childType == ASTNodeType::FUNC_CALL ||
+                               childType == ASTNodeType::NEW_EXPRESSION ||
                                childType == ASTNodeType::ARRAY_INIT ||
                                childType == ASTNodeType::CONSTANT) {
                         // This is an initializer - add it as a child to the last DeclaratorNode
@@ -663,8 +698,9 @@ void CompactASTReader::linkNodeChildren() {
                         const auto& declarations = varDeclNode->getDeclarations();
                         if (!declarations.empty()) {
                             auto* lastDecl = declarations.back().get();
-                            if (lastDecl && lastDecl->getType() == ASTNodeType::DECLARATOR_NODE) {
-                                DEBUG_OUT << "linkNodeChildren(): Adding initializer as child to DeclaratorNode" << std::endl;
+                            if (lastDecl && (lastDecl->getType() == ASTNodeType::DECLARATOR_NODE ||
+                                             lastDecl->getType() == ASTNodeType::ARRAY_DECLARATOR)) {
+                                DEBUG_OUT << "linkNodeChildren(): Adding initializer as child to declarator" << std::endl;
                                 const_cast<arduino_ast::ASTNode*>(lastDecl)->addChild(std::move(nodes_[childIndex]));
                             } else {
                                 DEBUG_OUT << "linkNodeChildren(): No DeclaratorNode to attach initializer to" << std::endl;
@@ -755,6 +791,10 @@ void CompactASTReader::linkNodeChildren() {
                     if (!memberAccessNode->getObject()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting object" << std::endl;
                         memberAccessNode->setObject(std::move(nodes_[childIndex]));
+                        
+                        // The exporter writes the operator token name as the node value
+                        const std::string token = memberAccessNode->getValueAs<std::string>();
+                        memberAccessNode->setAccessOperator(token == "ARROW" || token == "->" ? "->" : ".");
                     } else if (!memberAccessNode->getProperty()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting property" << std::endl;
                         memberAccessNode->setProperty(std::move(nodes_[childIndex]));
@@ -765,6 +805,77 @@ void CompactASTReader::linkNodeChildren() {
                 } else {
                     parentNode->addChild(std::move(nodes_[childIndex]));
                 }
+            } else if (parentNode->getType() == ASTNodeType::ARRAY_ACCESS) {
+                auto* arrayAccessNode = dynamic_cast<arduino_ast::ArrayAccessNode*>(parentNode.get());
+                if (arrayAccessNode) {
+                    
+                    // Array access expects: array, index. Files written before the exporter
+                    // mapped the array operand carry the index only.
+                    if (!arrayAccessNode->getArray() && childIndexList.size() > 1) {
+                        arrayAccessNode->setArray(std::move(nodes_[childIndex]));
+                    } else if (!arrayAccessNode->getIndex()) {
+                        arrayAccessNode->setIndex(std::move(nodes_[childIndex]));
+                    } else {
+                        parentNode->addChild(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::RANGE_FOR_STMT) {
+                auto* rangeForNode = dynamic_cast<arduino_ast::RangeBasedForStatement*>(parentNode.get());
+                if (rangeForNode) {
+                    
+                    // Range-based for expects: variable, iterable, body
+                    if (!rangeForNode->getVariable()) {
+                        rangeForNode->setVariable(std::move(nodes_[childIndex]));
+                    } else if (!rangeForNode->getIterable()) {
+                        rangeForNode->setIterable(std::move(nodes_[childIndex]));
+                    } else if (!rangeForNode->getBody()) {
+                        rangeForNode->setBody(std::move(nodes_[childIndex]));
+                    } else {
+                        parentNode->addChild(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::ARRAY_DECLARATOR) {
+                auto* arrayDeclNode = dynamic_cast<arduino_ast::ArrayDeclaratorNode*>(parentNode.get());
+                if (arrayDeclNode) {
+                    
+                    // Array declarators expect: identifier, then one size expression per
+                    // dimension (unsized dimensions such as "int a[]" are omitted)
+                    if (!arrayDeclNode->getIdentifier() && childNodeRef->getType() == ASTNodeType::IDENTIFIER) {
+                        arrayDeclNode->setIdentifier(std::move(nodes_[childIndex]));
+                    } else {
+                        arrayDeclNode->addDimension(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::STRUCT_MEMBER) {
+                auto* memberNode = dynamic_cast<arduino_ast::StructMemberNode*>(parentNode.get());
+                if (memberNode && childNodeRef->getType() == ASTNodeType::TYPE_NODE && !memberNode->getMemberType()) {
+                    memberNode->setMemberType(std::move(nodes_[childIndex]));
+                } else if (memberNode && childNodeRef->getType() == ASTNodeType::DECLARATOR_NODE) {
+                    memberNode->setMemberName(childNodeRef->getValueAs<std::string>());
+                } else {
+                    // Array members keep their ArrayDeclaratorNode for the dimensions
+                    if (memberNode && childNodeRef->getType() == ASTNodeType::ARRAY_DECLARATOR) {
+                        const auto* arrayDecl = dynamic_cast<const arduino_ast::ArrayDeclaratorNode*>(childNodeRef.get());
+                        if (arrayDecl && arrayDecl->getIdentifier()) {
+                            memberNode->setMemberName(arrayDecl->getIdentifier()->getValueAs<std::string>());
+                        }
+                    }
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::MULTIPLE_STRUCT_MEMBERS) {
+                // Shared member type first, then one declarator per member
+                auto* membersNode = dynamic_cast<arduino_ast::MultipleStructMembersNode*>(parentNode.get());
+                if (membersNode && childNodeRef->getType() != ASTNodeType::TYPE_NODE) {
+                    membersNode->addMember(std::move(nodes_[childIndex]));
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
             } else if (parentNode->getType() == ASTNodeType::IF_STMT) {
                 DEBUG_OUT << "linkNodeChildren(): Found IF_STMT parent node!" << std::endl;
                 auto* ifStmtNode = dynamic_cast<arduino_ast::IfStatement*>(parentNode.get());
@@ -887,6 +998,66 @@ void CompactASTReader::linkNodeChildren() {
                 } else {
                     parentNode->addChild(std::move(nodes_[childIndex]));
                 }
+            } else if (parentNode->getType() == ASTNodeType::POSTFIX_EXPRESSION) {
+                auto* postfixNode = dynamic_cast<arduino_ast::PostfixExpressionNode*>(parentNode.get());
+                if (postfixNode && !postfixNode->getOperand()) {
+                    
+                    // Postfix expressions expect: operand; the exporter writes "++" or "--" as the node value
+                    postfixNode->setOperand(std::move(nodes_[childIndex]));
+                    postfixNode->setOperator(postfixNode->getValueAs<std::string>());
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::RETURN_STMT) {
+                auto* returnNode = dynamic_cast<arduino_ast::ReturnStatement*>(parentNode.get());
+                if (returnNode && !returnNode->getReturnValue()) {
+                    returnNode->setReturnValue(std::move(nodes_[childIndex]));
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::NEW_EXPRESSION) {
+                auto* newNode = dynamic_cast<arduino_ast::NewExpressionNode*>(parentNode.get());
+                if (newNode) {
+                    
+                    // New expressions expect: allocated type, then constructor arguments
+                    if (!newNode->getTypeSpecifier()) {
+                        newNode->setTypeSpecifier(std::move(nodes_[childIndex]));
+                    } else {
+                        newNode->addArgument(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::SWITCH_STMT) {
+                auto* switchNode = dynamic_cast<arduino_ast::SwitchStatement*>(parentNode.get());
+                if (switchNode) {
+                    
+                    // Switch statements expect: discriminant, then one CaseStatement per case
+                    if (!switchNode->getCondition()) {
+                        switchNode->setCondition(std::move(nodes_[childIndex]));
+                    } else {
+                        parentNode->addChild(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
+            } else if (parentNode->getType() == ASTNodeType::CASE_STMT) {
+                auto* caseNode = dynamic_cast<arduino_ast::CaseStatement*>(parentNode.get());
+                if (caseNode) {
+                    
+                    // Case statements expect: test (absent for default), then the consequent
+                    // statements. A leading expression node is the test.
+                    auto childType = static_cast<uint8_t>(childNodeRef->getType());
+                    bool isExpression = childType >= static_cast<uint8_t>(ASTNodeType::BINARY_OP) &&
+                                        childType < static_cast<uint8_t>(ASTNodeType::TYPE_NODE);
+                    if (!caseNode->getLabel() && caseNode->getChildren().empty() && isExpression) {
+                        caseNode->setLabel(std::move(nodes_[childIndex]));
+                    } else {
+                        parentNode->addChild(std::move(nodes_[childIndex]));
+                    }
+                } else {
+                    parentNode->addChild(std::move(nodes_[childIndex]));
+                }
             } else if (parentNode->getType() == ASTNodeType::ASSIGNMENT) {
                 DEBUG_OUT << "linkNodeChildren(): Found ASSIGNMENT parent node!" << std::endl;
                 auto* assignmentNode = dynamic_cast<arduino_ast::AssignmentNode*>(parentNode.get());
@@ -897,6 +1068,11 @@ void CompactASTReader::linkNodeChildren() {
                     if (!assignmentNode->getLeft()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting left side" << std::endl;
                         assignmentNode->setLeft(std::move(nodes_[childIndex]));
+                        
+                        // The exporter writes the operator ("=", "+=", ...) as the node value
+                        if (assignmentNode->getOperator().empty()) {
+                            assignmentNode->setOperator(assignmentNode->getValueAs<std::string>());
+                        }
                     } else if (!assignmentNode->getRight()) {
                         DEBUG_OUT << "linkNodeChildren(): Setting right side" << std::endl;
                         assignmentNode->setRight(std::move(nodes_[childIndex]));
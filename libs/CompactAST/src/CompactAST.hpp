@@ -92,6 +92,7 @@ private:
     std::vector<std::string> stringTable_;
     std::vector<ASTNodePtr> nodes_;
     std::map<size_t, std::vector<uint16_t>> childIndices_; // nodeIndex -> child indices
+    ValueType lastValueType_ = ValueType::VOID_VAL;         // Encoding of the value parseValue() read last
     
     // Reading state
     bool headerRead_;
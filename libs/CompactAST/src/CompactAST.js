@@ -95,7 +95,10 @@ class CompactASTExporter {
             'CommaExpression': 0x56,
             'ArrayDeclaratorNode': 0x57,
             'PointerDeclaratorNode': 0x58,
-            'ConstructorCallNode': 0x59
+            'ConstructorCallNode': 0x59,
+            'NewExpression': 0x60,
+            'MultipleStructMembers': 0x5F,
+            'StructMember': 0x63
         };
         
         this.valueTypeMap = {
@@ -158,6 +161,9 @@ class CompactASTExporter {
         if (node.name && typeof node.name === 'string') {
             this.addString(node.name);
         }
+        if (node.typeName && typeof node.typeName === 'string') {
+            this.addString(node.typeName);
+        }
         
         let nextIndex = index + 1;
         
@@ -173,8 +179,8 @@ class CompactASTExporter {
         for (const childName of namedChildren) {
             if (node[childName]) {
                 if (Array.isArray(node[childName])) {
-                    // Special handling for VarDeclNode declarations array
-                    if (node.type === 'VarDeclNode' && childName === 'declarations') {
+                    // Special handling for VarDeclNode/MultipleStructMembers declarations array
+                    if ((node.type === 'VarDeclNode' || node.type === 'MultipleStructMembers') && childName === 'declarations') {
                         for (const decl of node[childName]) {
                             // Process declarator and initializer directly (skip declaration wrapper)
                             if (decl.declarator) {
@@ -211,15 +217,23 @@ class CompactASTExporter {
             'UnaryOpNode': ['operand'],
             'AssignmentNode': ['left', 'right'],
             'ExpressionStatement': ['expression'],
+            'ReturnStatement': ['value'],
             'MemberAccessNode': ['object', 'property'],
             'ParamNode': ['paramType', 'declarator', 'defaultValue'],
-            'ArrayAccessNode': ['object', 'index'],
+            'ArrayAccessNode': ['identifier', 'index'],
+            'ArrayDeclaratorNode': ['identifier', 'dimensions'],
+            'ArrayInitializerNode': ['elements'],
             'SwitchStatement': ['discriminant', 'cases'], 
             'CaseStatement': ['test', 'consequent'],
-            'RangeBasedForStatement': ['variable', 'iterable', 'body'],
+            'RangeBasedForStatement': ['declaration', 'range', 'body'],
             'TernaryExpression': ['condition', 'consequent', 'alternate'],
             'PostfixExpressionNode': ['operand'],
-            'CommaExpression': ['left', 'right']
+            'CommaExpression': ['left', 'right'],
+            'NewExpression': ['allocationType', 'arguments'],
+            'StructDeclaration': ['members'],
+            'StructMember': ['memberType', 'declarator'],
+            'MultipleStructMembers': ['memberType', 'declarations'],
+            'TypedefDeclaration': ['baseType']
         };
         
         return childrenMap[node.type] || [];
@@ -255,6 +269,16 @@ class CompactASTExporter {
         return undefined;
     }
     
+    /**
+     * Name a declaration node carries outside node.value: the struct tag of a
+     * StructDeclaration, the alias of a TypedefDeclaration. Undefined otherwise.
+     */
+    getDeclaredName(node) {
+        if (node.type === 'StructDeclaration' && typeof node.name === 'string') return node.name;
+        if (node.type === 'TypedefDeclaration' && typeof node.typeName === 'string') return node.typeName;
+        return undefined;
+    }
+    
     /**
      * [FROM CLAUDE]
      * A helper to log the structure of operator nodes for easy debugging.
@@ -309,6 +333,11 @@ class CompactASTExporter {
             size += this.calculateValueSize(node.value);
         }
         
+        // Add declared name size (struct/typedef names are written as the value)
+        if (node.value === undefined && !node.operator && this.getDeclaredName(node) !== undefined) {
+            size += 3; // ValueType + StringIndex
+        }
+        
         // Add operator size if present
         if (node.operator) {
             size += 3; // ValueType + StringIndex
@@ -444,10 +473,13 @@ class CompactASTExporter {
         const operatorString = this.getOperatorString(node);
 
         // Set HAS_VALUE flag ONLY if we will actually write a value
+        const declaredName = this.getDeclaredName(node);
         if (node.value !== undefined) {
             flags |= 0x02; // HAS_VALUE
         } else if (typeof operatorString === 'string') {
             flags |= 0x02; // HAS_VALUE for operator nodes, but only if operator exists
+        } else if (declaredName !== undefined) {
+            flags |= 0x02; // HAS_VALUE for struct/typedef names
         }
 
         view.setUint8(offset, flags);
@@ -459,11 +491,15 @@ class CompactASTExporter {
         const dataStartOffset = offset;
 
         // Write value if present (node.value takes precedence over operators)
-        if (node.value !== undefined) {
+        if (node.type === 'NumberNode' && node.isFloat) {
+            offset = this.writeFloat(view, offset, node.value); // Floating constant even when integral (2.0)
+        } else if (node.value !== undefined) {
             offset = this.writeValue(view, offset, node.value);
         } else if (typeof operatorString === 'string') {
             // Write the canonical operator we extracted
             offset = this.writeValue(view, offset, operatorString);
+        } else if (declaredName !== undefined) {
+            offset = this.writeValue(view, offset, declaredName);
         }
         // The faulty fallback that wrote an empty string is now removed.
         
@@ -564,22 +600,28 @@ class CompactASTExporter {
                 }
             }
         } else {
-            // Floating-point number
-            // Check if it can be represented accurately as float32
-            const float32Value = Math.fround(value);
-            // Use a small tolerance for floating-point comparison
-            const tolerance = 1e-7;
-            if (Math.abs(float32Value - value) < tolerance) {
-                // Can be represented as 32-bit float
-                view.setUint8(offset, 0x0A); // FLOAT32_VAL
-                view.setFloat32(offset + 1, value, true);
-                return offset + 5;
-            } else {
-                // Requires 64-bit precision
-                view.setUint8(offset, 0x0B); // FLOAT64_VAL
-                view.setFloat64(offset + 1, value, true);
-                return offset + 9;
-            }
+            return this.writeFloat(view, offset, value);
+        }
+    }
+
+    /**
+     * Write a floating-point constant as FLOAT32 when that is exact enough, FLOAT64 otherwise
+     */
+    writeFloat(view, offset, value) {
+        // Check if it can be represented accurately as float32
+        const float32Value = Math.fround(value);
+        // Use a small tolerance for floating-point comparison
+        const tolerance = 1e-7;
+        if (Math.abs(float32Value - value) < tolerance) {
+            // Can be represented as 32-bit float
+            view.setUint8(offset, 0x0A); // FLOAT32_VAL
+            view.setFloat32(offset + 1, value, true);
+            return offset + 5;
+        } else {
+            // Requires 64-bit precision
+            view.setUint8(offset, 0x0B); // FLOAT64_VAL
+            view.setFloat64(offset + 1, value, true);
+            return offset + 9;
         }
     }
     
@@ -598,8 +640,8 @@ class CompactASTExporter {
         for (const childName of namedChildren) {
             if (node[childName]) {
                 if (Array.isArray(node[childName])) {
-                    // Special handling for VarDeclNode declarations array
-                    if (node.type === 'VarDeclNode' && childName === 'declarations') {
+                    // Special handling for VarDeclNode/MultipleStructMembers declarations array
+                    if ((node.type === 'VarDeclNode' || node.type === 'MultipleStructMembers') && childName === 'declarations') {
                         for (const decl of node[childName]) {
                             // Process declarator and initializer directly (skip declaration wrapper)
                             if (decl.declarator && this.nodeMap.has(decl.declarator)) {
@@ -16,12 +16,20 @@
 #include "CommandProtocol.hpp"
 #include "FlexibleCommand.hpp"
 #include "CompactAST.hpp"
-#include "EnhancedInterpreter.hpp"
+#include "ArduinoDataTypes.hpp"
+#include "SimulatedMemory.hpp"
+#include "CallArguments.hpp"
 #include "ArduinoLibraryRegistry.hpp"
+#include "TargetProfiles.hpp"
+#include "ExecutionFiber.hpp"
+#include "SteadyStateDetector.hpp"
+#include "Value.hpp"
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <stack>
+#include <deque>
 #include <vector>
 #include <string>
 #include <functional>
@@ -37,7 +45,6 @@ namespace arduino_interpreter {
 class ASTInterpreter;
 class ScopeManager;
 class ArduinoLibraryInterface;
-class EnhancedScopeManager;
 
 // =============================================================================
 // INTERPRETER CONFIGURATION
@@ -55,6 +62,19 @@ struct InterpreterOptions {
     bool enableSerial = true;       // Enable Serial commands
     bool enablePins = true;         // Enable pin operations
     bool syncMode = false;          // Test mode: immediate sync responses for digitalRead/analogRead
+    TargetProfile targetProfile = TargetProfile::HOST;  // Data model: host (JS-compatible), avr8, esp32
+    size_t executionStackSize = 0;          // Async-mode evaluator stack in bytes (0: sized from the sketch's call graph)
+    bool steadyStateFastForward = false;    // Replay confirmed periodic loop() cycles instead of re-executing them
+    bool steadyStateVerify = false;         // Execute confirmed cycles anyway and check them against the template
+    uint32_t steadyStateMaxPeriod = 8;      // Longest loop() cycle (in iterations) the detector looks for
+    uint32_t steadyStateConfirmations = 3;  // Identical repeats required before a cycle is trusted
+    bool memoizePureFunctions = false;      // Cache results of side-effect-free user functions
+    size_t pureFunctionCacheSize = 256;     // Cached argument lists per function (cache resets when full)
+    bool preresolveParameters = false;      // Resolve user function parameter names and types at load time
+    size_t ramSize = 0;                     // Simulated RAM for arrays and malloc() in bytes (0: the target's SRAM)
+    size_t callStackSize = 0;               // Target stack for user function frames in bytes (0: the target's default)
+    bool traceExecution = true;             // Record into the process-wide g_tracer (unsynchronised: one thread at a time)
+    bool traceSwitchCases = false;          // Also emit SWITCH_CASE(matched=false) for each case tested before the match (JS stream)
     std::string version = "7.3.0";  // Interpreter version
 };
 
@@ -62,7 +82,7 @@ struct InterpreterOptions {
  * Variable representation matching JavaScript dynamic typing
  */
 struct Variable {
-    CommandValue value;
+    Value value;
     std::string type;
     bool isConst = false;
     bool isReference = false;
@@ -70,30 +90,37 @@ struct Variable {
     bool isGlobal = false;
     std::string templateType = "";  // For template instantiations like vector<int>
     Variable* referenceTarget = nullptr;  // For reference variables
+    StaticType staticType = StaticType::UNKNOWN;  // Declared type resolved by static type inference
+    uint32_t heapBlock = 0;  // String buffer in the simulated heap; owned by the variable's slot
     
-    Variable() : value(std::monostate{}), type("undefined") {}
+    Variable() : type("undefined") {}
     
-    template<typename T>
-    Variable(const T& val, const std::string& t = "", bool c = false, bool ref = false, bool stat = false, bool glob = false) 
-        : value(val), type(t), isConst(c), isReference(ref), isStatic(stat), isGlobal(glob) {}
+    template<typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, Variable>>>
+    Variable(T&& val, const std::string& t = "", bool c = false, bool ref = false, bool stat = false, bool glob = false) 
+        : value(std::forward<T>(val)), type(t), isConst(c), isReference(ref), isStatic(stat), isGlobal(glob) {}
+    
+    /** Stored value, following references */
+    const Value& current() const {
+        return isReference && referenceTarget ? referenceTarget->value : value;
+    }
+    
+    /** Stored value for in-place updates (String +=, reserve()), following references */
+    Value& mutableCurrent() {
+        return isReference && referenceTarget ? referenceTarget->value : value;
+    }
     
     template<typename T>
     T getValue() const {
-        if (isReference && referenceTarget) {
-            // Dereference the reference
-            if (std::holds_alternative<T>(referenceTarget->value)) {
-                return std::get<T>(referenceTarget->value);
+        T result{};
+        current().visit([&result](const auto& v) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(v)>, T>) {
+                result = v;
             }
-            return T{};
-        }
-        
-        if (std::holds_alternative<T>(value)) {
-            return std::get<T>(value);
-        }
-        return T{};
+        });
+        return result;
     }
     
-    void setValue(const CommandValue& val) {
+    void setValue(Value val) {
         if (isConst) {
             // Const variables cannot be modified after initialization
             return;
@@ -101,38 +128,53 @@ struct Variable {
         
         if (isReference && referenceTarget) {
             // Set value through reference
-            referenceTarget->setValue(val);
+            referenceTarget->setValue(std::move(val));
             return;
         }
         
-        value = val;
+        value = std::move(val);
     }
     
     // Type promotion/demotion utilities
     CommandValue promoteToType(const std::string& targetType) const {
-        CommandValue currentVal = isReference && referenceTarget ? referenceTarget->value : value;
+        if (targetType == "double" || targetType == "float") return promoteToType(StaticType::DOUBLE);
+        if (targetType == "int" || targetType == "int32_t") return promoteToType(StaticType::INT);
+        if (targetType == "bool") return promoteToType(StaticType::BOOL);
+        return current().toCommandValue();
+    }
+    
+    CommandValue promoteToType(StaticType targetType) const {
+        const Value& currentVal = current();
         
-        if (targetType == "double" || targetType == "float") {
-            if (std::holds_alternative<int32_t>(currentVal)) {
-                return static_cast<double>(std::get<int32_t>(currentVal));
-            } else if (std::holds_alternative<bool>(currentVal)) {
-                return static_cast<double>(std::get<bool>(currentVal) ? 1.0 : 0.0);
-            }
-        } else if (targetType == "int" || targetType == "int32_t") {
-            if (std::holds_alternative<double>(currentVal)) {
-                return static_cast<int32_t>(std::get<double>(currentVal));
-            } else if (std::holds_alternative<bool>(currentVal)) {
-                return static_cast<int32_t>(std::get<bool>(currentVal) ? 1 : 0);
-            }
-        } else if (targetType == "bool") {
-            if (std::holds_alternative<int32_t>(currentVal)) {
-                return std::get<int32_t>(currentVal) != 0;
-            } else if (std::holds_alternative<double>(currentVal)) {
-                return std::get<double>(currentVal) != 0.0;
-            }
+        switch (targetType) {
+            case StaticType::FLOAT:
+            case StaticType::DOUBLE:
+                if (currentVal.isInt()) {
+                    return static_cast<double>(currentVal.asInt());
+                } else if (currentVal.isBool()) {
+                    return currentVal.asBool() ? 1.0 : 0.0;
+                }
+                break;
+            case StaticType::INT:
+            case StaticType::INT32:
+                if (currentVal.isDouble()) {
+                    return target::wrapToInt32(currentVal.asDouble());
+                } else if (currentVal.isBool()) {
+                    return static_cast<int32_t>(currentVal.asBool() ? 1 : 0);
+                }
+                break;
+            case StaticType::BOOL:
+                if (currentVal.isInt()) {
+                    return currentVal.asInt() != 0;
+                } else if (currentVal.isDouble()) {
+                    return currentVal.asDouble() != 0.0;
+                }
+                break;
+            default:
+                break;
         }
         
-        return currentVal;
+        return currentVal.toCommandValue();
     }
     
     // Set reference target
@@ -150,72 +192,247 @@ struct Variable {
         if (isReference) modifiers += "& ";
         if (isGlobal) modifiers += "global ";
         
-        CommandValue displayValue = isReference && referenceTarget ? referenceTarget->value : value;
         std::string typeDisplay = templateType.empty() ? type : templateType;
         
-        return modifiers + typeDisplay + " = " + commandValueToString(displayValue);
+        return modifiers + typeDisplay + " = " + valueToString(current());
     }
 };
 
+/**
+ * Declaration type resolved once per VarDeclNode/ParamNode by the static type
+ * inference pass, so executing a declaration does no type-name parsing
+ */
+struct DeclaredType {
+    std::string declaredName;    // TypeNode spelling, e.g. "const unsigned long"
+    std::string cleanName;       // Without const/static/& qualifiers and template arguments
+    std::string templateType;    // Full template spelling (e.g. "vector<int>"), empty otherwise
+    StaticType staticType = StaticType::UNKNOWN;  // Conversion target under the bound profile
+    CommandValue defaultValue;   // Value when there is no initializer/argument
+    Ref<const StructLayout> structLayout;  // Set when the type is a declared struct
+    bool isConst = false;
+    bool isStatic = false;
+    bool isReference = false;
+};
+
+/**
+ * What an expression does in pointer code, resolved at load time from the
+ * declared pointer and array types (see planPointers). Expressions without
+ * an entry evaluate as plain values; a pointer variable already holds its
+ * address as an integer.
+ */
+struct PointerExpression {
+    enum class Role : uint8_t {
+        ADDRESS,     // Evaluates to an address: array name, &a[i], p + n, p++, malloc()
+        DIFFERENCE,  // p - q, counted in elements
+        LOAD,        // *p, p[i]
+        STORE,       // *p = v, p[i] += v (the assignment)
+        STEP         // p += n, p -= n (the assignment)
+    };
+    Role role = Role::ADDRESS;
+    ArduinoArray::ElementKind pointee = ArduinoArray::ElementKind::UINT8;  // Type stepped over and dereferenced
+    uint8_t elementSize = 1;
+    bool pointerOnRight = false;  // n + p: the right operand is the pointer
+};
+
+/**
+ * Hash of an argument list, keying the pure-function result cache
+ */
+struct CommandValueListHash {
+    size_t operator()(const std::vector<CommandValue>& values) const;
+};
+
+/**
+ * Result of one pure call and the commands its body emitted (nested
+ * FUNCTION_CALLs, VAR_SETs of locals, IF_STATEMENTs), replayed on a cache hit
+ * so the command stream is the same either way.
+ */
+struct PureResult {
+    CommandValue value;
+    std::vector<TypedCommand> commands;
+};
+
+/**
+ * Side-effect analysis result and result cache of one user function. A
+ * function is pure when it writes nothing but its own parameters and locals
+ * and only calls pure builtins (math, character tests) and other pure user
+ * functions; locals, if/switch and loops are fine. Variables it (or a callee)
+ * reads besides its own are part of the cache key, since lookups are dynamic.
+ */
+struct PureFunctionInfo {
+    bool pure = false;
+    std::vector<StaticType> parameterTypes;  // Arguments are keyed as bound, so 42 and 42.0 meet
+    std::vector<std::string> freeVariables;
+    std::unordered_map<std::vector<CommandValue>, PureResult, CommandValueListHash> results;
+};
+
+/**
+ * State of one purity analysis: the function analyzed (a call back into it is
+ * no reason to reject it), the parameters and locals in scope, and the other
+ * variables read so far.
+ */
+struct PurityScan {
+    const arduino_ast::FuncDefNode* function = nullptr;
+    std::vector<std::string> locals;
+    std::unordered_set<std::string> freeVariables;
+};
+
+/**
+ * Parameter names and types of a user function without default arguments,
+ * resolved once so binding a call does not walk the parameter nodes. Only
+ * the binding changes; see bindParameters.
+ */
+struct ParameterPlan {
+    struct Parameter {
+        std::string name;
+        const DeclaredType* type;
+    };
+    std::vector<Parameter> parameters;
+};
+
+/**
+ * User function known at load time. Call frames refer to it by index;
+ * frameBytes is what one call takes of the target's stack.
+ */
+struct FunctionInfo {
+    const arduino_ast::FuncDefNode* definition = nullptr;
+    std::string name;
+    size_t frameBytes = 0;          // Return address, saved registers and parameters
+    uint32_t activeCalls = 0;       // Frames of this function on the call stack
+};
+
+/**
+ * Activation record of a user function call. Frames are pooled: the stack
+ * only grows, so calls at a depth reached before reuse their frame.
+ */
+struct CallFrame {
+    uint32_t functionId = 0;        // Index into the function table
+    CommandValue returnValue;       // Return slot, written by return statements
+    size_t localsBase = 0;          // Scope depth below the call's parameters and locals
+    size_t stackBytes = 0;          // Target stack in use up to and including this frame
+};
+
+/**
+ * Case dispatch of one switch statement, built at load time. Constant
+ * integer labels resolve the entry case directly: a dense jump table when the
+ * labels are packed, a sorted array otherwise. Switches with any other label
+ * scan their cases in order.
+ */
+struct SwitchDispatch {
+    enum class Kind { DENSE, SORTED, SCAN };
+    
+    Kind kind = Kind::SCAN;
+    std::vector<const arduino_ast::CaseStatement*> cases;  // Source order
+    std::vector<CommandValue> labels;                      // Constant label per case (monostate if not constant)
+    int32_t defaultCase = -1;
+    int32_t denseBase = 0;
+    std::vector<int32_t> denseTable;                       // label - denseBase -> case index, -1 = no case
+    std::vector<std::pair<int32_t, int32_t>> sortedLabels; // (label, case index) ordered by label
+};
+
+/**
+ * Struct member named by one MemberAccessNode. Resolved at load time when the
+ * object's declared type is known; an instance of another layout reaching the
+ * node re-resolves it by name.
+ */
+struct MemberSlot {
+    const StructLayout* layout = nullptr;
+    int32_t field = -1;
+};
+
 // =============================================================================
 // SCOPE MANAGEMENT
 // =============================================================================
 
 /**
- * Variable scope management matching JavaScript scope stack
+ * Frame-based variable store for every kind of variable: scalars, strings,
+ * arrays and structs share one slot stack. Each frame is a contiguous run of
+ * slots; each name maps to the stack of slots currently binding it, so a
+ * lookup is a single hash probe (innermost binding wins, as with nested
+ * scopes) and popping a frame unbinds exactly the slots it created.
  */
 class ScopeManager {
 private:
-    std::vector<std::unordered_map<std::string, Variable>> scopes_;
+    std::deque<Variable> slots_;                // deque keeps Variable* stable while frames come and go
+    std::vector<std::vector<uint32_t>*> slotBindings_;  // Binding stack each slot was pushed on
+    std::vector<size_t> frames_;                // First slot of each frame
+    std::unordered_map<std::string, std::vector<uint32_t>> bindings_;  // Name -> binding slots, innermost last
     std::unordered_map<std::string, Variable> staticVariables_;  // Static variables persist across scopes
+    SimulatedMemory* memory_;                   // Heap of the variables' String buffers (may be null)
+    
+    void releaseHeap(Variable& var) {
+        if (memory_ && var.heapBlock) memory_->release(var.heapBlock);
+        var.heapBlock = 0;
+    }
+    
+    bool boundInCurrentFrame(const std::vector<uint32_t>& binding) const {
+        return !binding.empty() && binding.back() >= frames_.back();
+    }
     
 public:
-    ScopeManager() {
+    explicit ScopeManager(SimulatedMemory* memory = nullptr) : memory_(memory) {
         pushScope(); // Global scope
         markCurrentScopeAsGlobal();
     }
     
     void pushScope() {
-        scopes_.emplace_back();
+        frames_.push_back(slots_.size());
     }
     
     void popScope() {
-        if (scopes_.size() > 1) { // Keep global scope
-            scopes_.pop_back();
+        if (frames_.size() > 1) { // Keep global scope
+            size_t first = frames_.back();
+            while (slots_.size() > first) {
+                slotBindings_.back()->pop_back();
+                slotBindings_.pop_back();
+                releaseHeap(slots_.back());
+                slots_.pop_back();
+            }
+            frames_.pop_back();
         }
     }
     
     void setVariable(const std::string& name, const Variable& var) {
         Variable newVar = var;
+        newVar.heapBlock = 0;  // A heap block stays with the slot that owns it
         
         // Mark as global if we're in global scope
-        if (scopes_.size() == 1) {
+        if (frames_.size() == 1) {
             newVar.isGlobal = true;
         }
         
         if (newVar.isStatic) {
             // Static variables go in special storage
-            staticVariables_[name] = newVar;
-        } else {
-            scopes_.back()[name] = newVar;
+            Variable& slot = staticVariables_[name];
+            newVar.heapBlock = slot.heapBlock;
+            slot = std::move(newVar);
+            return;
+        }
+        
+        std::vector<uint32_t>& binding = bindings_[name];
+        if (boundInCurrentFrame(binding)) {
+            newVar.heapBlock = slots_[binding.back()].heapBlock;
+            slots_[binding.back()] = std::move(newVar);
+            return;
         }
+        binding.push_back(static_cast<uint32_t>(slots_.size()));
+        slotBindings_.push_back(&binding);
+        slots_.push_back(std::move(newVar));
     }
     
     Variable* getVariable(const std::string& name) {
         // First check static variables
-        auto staticFound = staticVariables_.find(name);
-        if (staticFound != staticVariables_.end()) {
-            return &staticFound->second;
+        if (!staticVariables_.empty()) {
+            auto staticFound = staticVariables_.find(name);
+            if (staticFound != staticVariables_.end()) {
+                return &staticFound->second;
+            }
         }
         
-        // Search from current scope backwards
-        for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-            auto found = it->find(name);
-            if (found != it->end()) {
-                return &found->second;
-            }
+        auto found = bindings_.find(name);
+        if (found == bindings_.end() || found->second.empty()) {
+            return nullptr;
         }
-        return nullptr;
+        return &slots_[found->second.back()];
     }
     
     bool hasVariable(const std::string& name) const {
@@ -224,33 +441,38 @@ public:
             return true;
         }
         
-        for (auto it = scopes_.rbegin(); it != scopes_.rend(); ++it) {
-            if (it->find(name) != it->end()) {
-                return true;
-            }
-        }
-        return false;
+        auto found = bindings_.find(name);
+        return found != bindings_.end() && !found->second.empty();
     }
     
-    size_t getScopeDepth() const { return scopes_.size(); }
+    size_t getScopeDepth() const { return frames_.size(); }
     
     // Get total variable count across all scopes
     uint32_t getVariableCount() const {
-        uint32_t count = static_cast<uint32_t>(staticVariables_.size());
-        for (const auto& scope : scopes_) {
-            count += static_cast<uint32_t>(scope.size());
-        }
-        return count;
+        return static_cast<uint32_t>(staticVariables_.size() + slots_.size());
     }
     
-    bool isGlobalScope() const { return scopes_.size() == 1; }
+    bool isGlobalScope() const { return frames_.size() == 1; }
+    
+    // Visit variables that outlive a function call (globals and statics)
+    template<typename Fn>
+    void forEachPersistentVariable(Fn&& fn) const {
+        size_t globalEnd = frames_.size() > 1 ? frames_[1] : slots_.size();
+        for (const auto& [name, binding] : bindings_) {
+            for (uint32_t slot : binding) {
+                if (slot >= globalEnd) break;
+                fn(name, slots_[slot]);
+            }
+        }
+        for (const auto& [name, var] : staticVariables_) {
+            fn(name, var);
+        }
+    }
     
     void markCurrentScopeAsGlobal() {
         // Mark all variables in current scope as global
-        if (!scopes_.empty()) {
-            for (auto& [name, var] : scopes_.back()) {
-                var.isGlobal = true;
-            }
+        for (size_t i = frames_.back(); i < slots_.size(); ++i) {
+            slots_[i].isGlobal = true;
         }
     }
     
@@ -276,12 +498,43 @@ public:
     }
     
     void clear() {
-        scopes_.clear();
+        for (auto& slot : slots_) releaseHeap(slot);
+        for (auto& [name, var] : staticVariables_) releaseHeap(var);
+        slots_.clear();
+        slotBindings_.clear();
+        frames_.clear();
+        bindings_.clear();
         staticVariables_.clear();
         pushScope(); // Global scope
     }
 };
 
+/**
+ * Struct member and array element access on variables in the ScopeManager
+ */
+class MemberAccessHelper {
+public:
+    static EnhancedCommandValue getMemberValue(ScopeManager* scopeManager,
+                                               const std::string& objectName,
+                                               const std::string& memberName);
+    
+    // Turns a variable without a struct value into one on first member assignment
+    static void setMemberValue(ScopeManager* scopeManager,
+                               const std::string& objectName,
+                               const std::string& memberName,
+                               const EnhancedCommandValue& value);
+    
+    static EnhancedCommandValue getArrayElement(ScopeManager* scopeManager,
+                                                const std::string& arrayName,
+                                                size_t index);
+    
+    // Grows the array as needed; turns a variable without an array value into one
+    static void setArrayElement(ScopeManager* scopeManager,
+                                const std::string& arrayName,
+                                size_t index,
+                                const EnhancedCommandValue& value);
+};
+
 // =============================================================================
 // REQUEST-RESPONSE SYSTEM
 // =============================================================================
@@ -302,9 +555,9 @@ private:
     InterpreterOptions options_;
     ExecutionState state_;
     
-    // Managers
+    // Managers (RAM first: the variable store holds arrays whose storage lives in it)
+    std::unique_ptr<SimulatedMemory> memory_;
     std::unique_ptr<ScopeManager> scopeManager_;
-    std::unique_ptr<EnhancedScopeManager> enhancedScopeManager_;
     std::unique_ptr<ArduinoLibraryInterface> libraryInterface_;  // Legacy - to be deprecated
     std::unique_ptr<ArduinoLibraryRegistry> libraryRegistry_;    // New comprehensive system
     
@@ -320,6 +573,8 @@ private:
     uint32_t maxLoopIterations_;
     std::chrono::steady_clock::time_point executionStart_;
     
+    int32_t nextEnumValue_ = 0;  // Value of the next implicitly numbered enum member
+    
     // Function tracking - MEMORY SAFE: Store function names and look up in AST tree
     arduino_ast::ASTNode* currentFunction_;
     std::unordered_set<std::string> userFunctionNames_;
@@ -330,18 +585,23 @@ private:
     bool shouldReturn_;
     CommandValue returnValue_;
     
-    // Switch statement state management
-    CommandValue currentSwitchValue_;
-    bool inSwitchFallthrough_ = false;
-    
-    // Continuation-based execution system for non-blocking operations
-    arduino_ast::ASTNode* suspendedNode_;
-    int suspendedChildIndex_;                  // Track child index in CompoundStmtNode for resumption
-    arduino_ast::ASTNode* currentCompoundNode_; // Track current compound statement being executed
-    int currentChildIndex_;                    // Track current child index being executed
+    // Suspendable execution for non-blocking operations (async mode): the program
+    // runs on its own stack and yields while an external response is pending, so
+    // every call, block and expression frame is kept intact across the wait
+    std::unique_ptr<ExecutionFiber> programFiber_;
+    CommandValue resumeValue_;                 // Response handed to the suspended request on resume
+    
+    // Cooperative preemption budget of the current tickFor()/tickSteps() slice
+    bool sliceActive_ = false;
+    bool sliceTimed_ = false;
+    uint64_t sliceStepsRemaining_ = 0;
+    std::chrono::steady_clock::time_point sliceDeadline_;
+    
+    // Steady-state loop() detection (opt-in, see InterpreterOptions)
+    std::unique_ptr<SteadyStateDetector> steadyState_;
+    uint32_t fastForwardedIterations_ = 0;
+    uint32_t steadyStateMismatches_ = 0;
     std::string waitingForRequestId_;
-    std::string suspendedFunction_;
-    CommandValue lastExpressionResult_;
     ExecutionState previousExecutionState_;
     
     // Request-response system
@@ -353,9 +613,7 @@ private:
     // =============================================================================
     bool inTick_;                          // Prevent re-entry in tick()
     uint32_t requestIdCounter_;            // For generateRequestId()
-    std::vector<std::string> callStack_;   // Function call stack tracking
-    int allocationCounter_;                // malloc allocation counter
-    int mallocCounter_;                    // malloc request counter
+    int allocationCounter_;                // new allocation counter
     
     // =============================================================================
     // PERFORMANCE TRACKING & STATISTICS
@@ -370,7 +628,8 @@ private:
     // Command generation statistics
     uint32_t commandsGenerated_;
     uint32_t errorsGenerated_;
-    std::unordered_map<std::string, uint32_t> commandTypeCounters_;
+    std::array<uint32_t, static_cast<size_t>(TypedCommand::Kind::KIND_COUNT)> commandTypeCounters_{};
+    CommandNamePool commandNames_;  // Variable and function names of emitted commands, made once per name
     
     // Function call statistics
     uint32_t functionsExecuted_;
@@ -378,6 +637,7 @@ private:
     uint32_t arduinoFunctionsExecuted_;
     std::unordered_map<std::string, uint32_t> functionCallCounters_;
     std::unordered_map<std::string, std::chrono::microseconds> functionExecutionTimes_;
+    uint32_t pureCacheHits_ = 0;
     
     // Loop iteration statistics
     uint32_t loopsExecuted_;
@@ -409,7 +669,6 @@ private:
     uint32_t serialOperations_;
     
     // Error and performance tracking
-    uint32_t recursionDepth_;
     uint32_t maxRecursionDepth_;
     uint32_t timeoutOccurrences_;
     uint32_t memoryAllocations_;
@@ -423,6 +682,72 @@ private:
     uint32_t stackOverflowErrors_;
     uint32_t memoryExhaustionErrors_;
     size_t memoryLimit_;  // Memory limit for ESP32-S3 (512KB + 8MB PSRAM)
+    
+    // =============================================================================
+    // TARGET DATA MODEL (bound once per instance to a TargetProfiles.hpp policy)
+    // =============================================================================
+    using BinaryOperationFn = Value (ASTInterpreter::*)(const std::string&, const Value&, const Value&, StaticType);
+    using ConvertToTypeFn = CommandValue (ASTInterpreter::*)(const CommandValue&, const std::string&);
+    using DefaultValueFn = CommandValue (ASTInterpreter::*)(const std::string&);
+    BinaryOperationFn binaryOperationImpl_ = nullptr;
+    ConvertToTypeFn convertToTypeImpl_ = nullptr;
+    DefaultValueFn defaultValueImpl_ = nullptr;
+    using ConvertValueFn = Value (ASTInterpreter::*)(const Value&, StaticType);
+    ConvertValueFn convertValueImpl_ = nullptr;
+    bool nativeDataModel_ = false;               // Stores narrow to the declared type (ASTInterpreter.js does not)
+    
+    // Static type inference results keyed by VarDeclNode/ParamNode
+    std::unordered_map<const arduino_ast::ASTNode*, DeclaredType> declaredTypes_;
+    
+    // Static types of expressions (literals, operators, calls), resolved at load time
+    std::unordered_map<const arduino_ast::ASTNode*, StaticType> expressionTypes_;
+    std::unordered_map<const arduino_ast::ASTNode*, StaticType> operationTypes_;  // Type operators compute in (native profiles)
+    
+    // Pure-function analysis, done on a function's first call (globals exist by then)
+    std::unordered_map<const arduino_ast::FuncDefNode*, PureFunctionInfo> pureFunctions_;
+    std::vector<TypedCommand> pureTranscript_;  // Commands emitted while pure calls run
+    uint32_t pureRecorders_ = 0;                // Pure calls whose body is running
+    
+    // User function definitions by name and parameter plans, resolved at load time
+    std::unordered_map<std::string, arduino_ast::ASTNode*> functionIndex_;
+    std::unordered_map<const arduino_ast::FuncDefNode*, ParameterPlan> parameterPlans_;
+    
+    // User functions by id and the pooled call stack; callDepth_ frames are in use
+    std::vector<FunctionInfo> functionTable_;
+    std::unordered_map<const arduino_ast::FuncDefNode*, uint32_t> functionIds_;
+    std::vector<CallFrame> callFrames_;
+    size_t callDepth_ = 0;
+    size_t callStackBudget_ = 0;                 // Target stack bytes the frames may use
+    size_t peakCallStackBytes_ = 0;
+    uintptr_t hostStackBase_ = 0;                // Evaluator stack address at the outermost call
+    size_t hostStackLimit_ = 0;                  // Host stack the calls may use below hostStackBase_
+    size_t executionStackBytes_ = 0;             // Evaluator fiber size for this sketch (planExecutionStack)
+    
+    // Switch dispatch tables, built at load time
+    std::unordered_map<const arduino_ast::SwitchStatement*, SwitchDispatch> switchTables_;
+    
+    // Struct layouts by type name (typedef aliases included) and member slots, resolved at load time
+    std::unordered_map<std::string, Ref<const StructLayout>> structLayouts_;
+    std::unordered_map<const arduino_ast::MemberAccessNode*, MemberSlot> memberSlots_;
+    
+    // Interned string literals; values of literals, constants and F()/PSTR() wrappers, resolved at load time
+    StringPool stringPool_;
+    std::unordered_map<const arduino_ast::ASTNode*, Value> literalValues_;
+    
+    // Output of the formatting C string builtins, reused so sprintf in loop() does not allocate
+    std::string formatBuffer_;
+    
+    // Pointer roles of expressions, resolved at load time
+    std::unordered_map<const arduino_ast::ASTNode*, PointerExpression> pointerExpressions_;
+    
+    // Callee names of calls ("Serial.println" for member calls), resolved on first execution
+    std::unordered_map<const arduino_ast::FuncCallNode*, std::string> calleeNames_;
+    
+    // Transient storage of the current tick (long argument lists), reset after every loop() pass
+    TickArena tickArena_;
+    
+    // Argument texts of generic FUNCTION_CALL commands, reused across calls
+    std::vector<std::string> callArgStrings_;
 
 public:
     /**
@@ -480,6 +805,52 @@ public:
      */
     void tick();
     
+    /**
+     * Time-budgeted tick: run until the budget is spent, the program waits for
+     * a response, or it completes. Execution is preempted cooperatively at loop
+     * back-edges and call boundaries and continues mid-iteration on the next
+     * call. The first call on an idle interpreter starts the program.
+     * @return true while the program has more work (running or waiting)
+     */
+    bool tickFor(std::chrono::microseconds budget);
+    
+    /**
+     * Quota tick: like tickFor(), bounded by a number of preemption points
+     * (loop back-edges and call boundaries) instead of wall-clock time
+     */
+    bool tickSteps(uint64_t steps);
+    
+    /**
+     * End the current budgeted slice at the next preemption point (e.g. a host
+     * parking the instance on a virtual-time delay)
+     */
+    void requestPreemption() {
+        if (sliceActive_) {
+            sliceTimed_ = false;
+            sliceStepsRemaining_ = 0;
+        }
+    }
+    
+    /**
+     * Turn recording into g_tracer on or off for this interpreter only
+     */
+    void setExecutionTracing(bool enabled) { options_.traceExecution = enabled; }
+    
+    /**
+     * Number of loop() iterations started so far
+     */
+    uint32_t getLoopIteration() const { return currentLoopIteration_; }
+    
+    /**
+     * loop() iterations replayed from a steady-state template instead of executed
+     */
+    uint32_t getFastForwardedIterations() const { return fastForwardedIterations_; }
+    
+    /**
+     * Verification mode: executed iterations that diverged from their template
+     */
+    uint32_t getSteadyStateMismatches() const { return steadyStateMismatches_; }
+    
     /**
      * Resume execution with external data response
      * @param requestId The request ID that this response is for
@@ -625,6 +996,7 @@ public:
         uint32_t variableCount;
         uint32_t pendingRequests;
         uint32_t memoryAllocations;
+        SimulatedMemory::Stats heap;        // Simulated RAM: live/peak bytes, largest free block
     };
     
     MemoryStats getMemoryStats() const;
@@ -648,6 +1020,7 @@ public:
         uint32_t arrayAccessCount;
         uint32_t structAccessCount;
         uint32_t maxRecursionDepth;
+        size_t peakCallStackBytes;      // Deepest target stack use of user function frames
     };
     
     ExecutionStats getExecutionStats() const;
@@ -675,6 +1048,7 @@ public:
         std::unordered_map<std::string, std::chrono::microseconds> executionTimes;
         std::string mostCalledFunction;
         std::string slowestFunction;
+        uint32_t pureCacheHits = 0;  // User function calls answered from the pure-function cache
     };
     
     FunctionCallStats getFunctionCallStats() const;
@@ -710,6 +1084,11 @@ public:
     
     ErrorStats getErrorStats() const;
     
+    /**
+     * Simulated RAM holding declared arrays and malloc() blocks
+     */
+    const SimulatedMemory& getMemory() const { return *memory_; }
+    
     /**
      * Reset all performance statistics
      */
@@ -720,10 +1099,14 @@ public:
     // =============================================================================
     
     int32_t convertToInt(const CommandValue& value);
+    int32_t convertToInt(const Value& value);
     double convertToDouble(const CommandValue& value);
+    double convertToDouble(const Value& value);
     std::string convertToString(const CommandValue& value);
     bool convertToBool(const CommandValue& value);
+    bool convertToBool(const Value& value);
     bool isNumeric(const CommandValue& value);
+    bool isNumeric(const Value& value);
     
     // =============================================================================
     // ENHANCED ERROR HANDLING
@@ -767,39 +1150,127 @@ private:
     void executeProgram();
     void executeSetup();
     void executeLoop();
+    void executeLoopIteration(arduino_ast::ASTNode* loopFunc);  // One loop() call, replayed when a cycle is locked
+    void executeLoopBody(arduino_ast::ASTNode* loopFunc);
     void executeFunctions();
     
+    // Steady-state fast-forward
+    bool canReplaySteadyState() const;
+    uint64_t fingerprintPersistentState() const;
+    
     // Expression evaluation
     CommandValue evaluateExpression(arduino_ast::ASTNode* expr);
-    CommandValue evaluateBinaryOperation(const std::string& op, const CommandValue& left, const CommandValue& right);
+    CommandValue evaluateBinaryOperation(const std::string& op, const CommandValue& left, const CommandValue& right,
+                                         StaticType operandType = StaticType::UNKNOWN);
+    Value evaluateBinaryOperation(const std::string& op, const Value& left, const Value& right,
+                                  StaticType operandType = StaticType::UNKNOWN);
+    template<typename T>
+    bool evaluateTypedOperation(const std::string& op, const Value& left, const Value& right, Value& result);
+    Value stepVariable(Variable& var, int32_t step, StaticType operandType);
+    Value narrowToDeclared(const Value& value, StaticType staticType);
     CommandValue evaluateUnaryOperation(const std::string& op, const CommandValue& operand);
     CommandValue evaluateComparison(const std::string& op, const CommandValue& left, const CommandValue& right);
     CommandValue evaluateLogical(const std::string& op, const CommandValue& left, const CommandValue& right);
     
+    // Value-returning evaluation of expression nodes; visit() wraps these for statement use
+    CommandValue evaluateArrayAccess(arduino_ast::ArrayAccessNode& node);
+    CommandValue evaluateMemberAccess(arduino_ast::MemberAccessNode& node);
+    Value evaluateAssignment(arduino_ast::AssignmentNode& node);
+    Value evaluateBinaryExpression(arduino_ast::BinaryOpNode& node);
+    Value evaluateUnaryExpression(arduino_ast::UnaryOpNode& node);
+    CommandValue evaluateNamespaceAccess(arduino_ast::NamespaceAccessNode& node);
+    CommandValue evaluateCppCast(arduino_ast::CppCastNode& node);
+    CommandValue evaluateFunctionStyleCast(arduino_ast::FunctionStyleCastNode& node);
+    CommandValue evaluateWideCharLiteral(arduino_ast::WideCharLiteralNode& node);
+    CommandValue evaluateDesignatedInitializer(arduino_ast::DesignatedInitializerNode& node);
+
+    // Arrays: typed declarations, subscripts and memset/memcpy on packed storage
+    void declareArray(arduino_ast::ArrayDeclaratorNode& node, const DeclaredType& declType);
+    void fillArrayInitializer(ArduinoArray& array, const arduino_ast::ASTNode& initializer,
+                              size_t level, size_t base, StaticType elementType);
+    bool evaluateArrayIndices(const arduino_ast::ArrayAccessNode& node, std::string& arrayName,
+                              int32_t* indices, size_t& depth);
+    bool arrayElementIndex(const ArduinoArray& array, const std::string& arrayName,
+                           const int32_t* indices, size_t depth, size_t& flatIndex);
+    bool evaluateArrayBuiltin(const std::string& name, arduino_ast::FuncCallNode& node, CommandValue& result);
+    
+    // Strings: interned literals, one-pass + chains, in-place += and String methods on the variable's own buffer
+    void internLiterals(const arduino_ast::ASTNode* node);
+    const Value* findLiteral(const arduino_ast::ASTNode* node) const;
+    Value evaluateValue(const arduino_ast::ASTNode* node);
+    Value evaluateConcatenation(arduino_ast::BinaryOpNode& node);
+    void appendStringPiece(std::string& out, const arduino_ast::ASTNode* source, const Value& value) const;
+    bool appendToString(const std::string& varName, const arduino_ast::ASTNode* source, const Value& value);
+    bool evaluateStringBuiltin(arduino_ast::FuncCallNode& node, CommandValue& result);
+    void reserveStringHeap(Variable* var, size_t capacity, const std::string& varName);
+    
+    // C strings: strcpy/strcat/sprintf/dtostrf/itoa... on char arrays' packed bytes
+    bool evaluateCStringBuiltin(const std::string& name, arduino_ast::FuncCallNode& node, CommandValue& result);
+    
+    // Pointers: addresses into the simulated RAM, arithmetic scaled by the pointee size
+    void planPointers();
+    const PointerExpression* findPointerExpression(const arduino_ast::ASTNode* node) const;
+    CommandValue evaluatePointerExpression(const arduino_ast::ASTNode& node, const PointerExpression& pointer);
+    CommandValue evaluatePointerAssignment(const arduino_ast::AssignmentNode& node, const PointerExpression& pointer);
+    int32_t evaluateAddress(const arduino_ast::ASTNode* node);
+    int32_t computeAddress(const arduino_ast::ASTNode& node, const PointerExpression& pointer);
+    int32_t dereferenceAddress(const arduino_ast::ASTNode& node, const PointerExpression& pointer);
+    bool holdsAddress(const arduino_ast::ASTNode* node);
+    bool evaluateMemoryBuiltin(const std::string& name, arduino_ast::FuncCallNode& node, CommandValue& result);
+    uint8_t* pointerTarget(int32_t address, size_t size, const std::string& access);
+    
+    // Structs: load-time layouts, member slots and copy-on-write value semantics
+    void buildStructLayouts(const arduino_ast::ASTNode* node);
+    Ref<const StructLayout> computeStructLayout(const arduino_ast::ASTNode& declaration,
+                                                            const std::string& typeName);
+    Ref<const StructLayout> findStructLayout(const std::string& typeName) const;
+    const StructLayout* planMemberSlots(const arduino_ast::ASTNode* node,
+                                        std::unordered_map<std::string, const StructLayout*>& objectLayouts);
+    int32_t resolveMemberSlot(const arduino_ast::MemberAccessNode& node, const ArduinoStruct& object);
+    const std::string& calleeName(const arduino_ast::FuncCallNode& node);
+    const ArduinoStruct* structOperand(const arduino_ast::ASTNode* node);
+    ArduinoStruct* mutableStructOperand(const arduino_ast::ASTNode* node);
+    void declareStruct(const std::string& varName, const DeclaredType& declType, const arduino_ast::ASTNode* initializer);
+    void fillStructInitializer(ArduinoStruct& object, const arduino_ast::ASTNode& initializer);
+    bool assignStruct(const arduino_ast::ASTNode* target, const arduino_ast::ASTNode* source);
+    void storeStructMember(ArduinoStruct& object, size_t field, const CommandValue& value);
+
     // Arduino function handling
-    CommandValue executeArduinoFunction(const std::string& name, const std::vector<CommandValue>& args);
-    CommandValue executeUserFunction(const std::string& name, const arduino_ast::FuncDefNode* funcDef, const std::vector<CommandValue>& args);
-    CommandValue handlePinOperation(const std::string& function, const std::vector<CommandValue>& args);
-    CommandValue handleTimingOperation(const std::string& function, const std::vector<CommandValue>& args);
-    CommandValue handleSerialOperation(const std::string& function, const std::vector<CommandValue>& args);
-    CommandValue handleMultipleSerialOperation(const std::string& portName, const std::string& methodName, const std::vector<CommandValue>& args);
+    CommandValue executeArduinoFunction(const std::string& name, const CallArguments& args);
+    CommandValue executeUserFunction(const std::string& name, const arduino_ast::FuncDefNode* funcDef, const CallArguments& args);
+    bool bindParameters(const std::string& name, const arduino_ast::FuncDefNode* funcDef, const CallArguments& args);
+    CommandValue handlePinOperation(const std::string& function, const CallArguments& args);
+    CommandValue handleTimingOperation(const std::string& function, const CallArguments& args);
+    CommandValue handleSerialOperation(const std::string& function, const CallArguments& args);
+    CommandValue handleMultipleSerialOperation(const std::string& portName, const std::string& methodName, const CallArguments& args);
     
     // Helper methods for Serial system
     std::string generateRequestId(const std::string& prefix);
     CommandValue waitForResponse(const std::string& requestId);
     
-    // External data functions using continuation pattern
-    void requestAnalogRead(int32_t pin);
-    void requestDigitalRead(int32_t pin);
-    void requestMillis();
-    void requestMicros();
+    // External data functions (suspend until the parent application responds)
+    CommandValue requestAnalogRead(int32_t pin);
+    CommandValue requestDigitalRead(int32_t pin);
+    CommandValue requestMillis();
+    CommandValue requestMicros();
+    
+    // Program fiber control
+    bool beginProgram();
+    bool runSlice();
+    void continueProgram();
+    void resumeProgramFiber();
+    void completeProgram();
+    
+    // Preemption point (loop back-edges, call boundaries); free when no slice is active
+    void preemptionPoint() { if (sliceActive_) checkSliceBudget(); }
+    void checkSliceBudget();
     
     // Continuation helpers
     bool hasResponse(const std::string& requestId) const;
     CommandValue consumeResponse(const std::string& requestId);
     
     // Command emission
-    void emitCommand(FlexibleCommand command);
+    void emitCommand(TypedCommand command);
     void emitError(const std::string& message, const std::string& type = "RuntimeError");
     void emitSystemCommand(CommandType type, const std::string& message);
     
@@ -825,6 +1296,58 @@ private:
     // Type conversion utilities
     CommandValue convertToType(const CommandValue& value, const std::string& typeName);
     
+    // Per-profile instantiations behind evaluateBinaryOperation/convertToType/getDefaultValueForType
+    void bindTargetProfile(TargetProfile profile);
+    template<typename Profile>
+    Value evaluateBinaryOperationFor(const std::string& op, const Value& left, const Value& right, StaticType operandType);
+    template<typename Profile>
+    CommandValue convertToTypeFor(const CommandValue& value, const std::string& typeName);
+    template<typename Profile>
+    CommandValue getDefaultValueForTypeFor(const std::string& type);
+    template<typename Profile>
+    Value convertValueFor(const Value& value, StaticType staticType);
+    CommandValue convertToType(const CommandValue& value, StaticType staticType);
+    Value convertToType(const Value& value, StaticType staticType);
+    
+    // Static type inference (load time)
+    void inferStaticTypes(const arduino_ast::ASTNode* node);
+    DeclaredType analyzeDeclaredType(const std::string& typeName) const;
+    const DeclaredType* getDeclaredType(const arduino_ast::ASTNode* node) const;
+    void inferExpressionTypes();
+    StaticType getExpressionType(const arduino_ast::ASTNode* node) const;
+    StaticType getOperationType(const arduino_ast::ASTNode* node) const;
+    
+    // Pure user function memoization
+    PureFunctionInfo* lookupPureFunction(const arduino_ast::FuncDefNode* funcDef);
+    bool isSideEffectFree(const arduino_ast::ASTNode* node, PurityScan& scan);
+    void rememberPureResult(PureFunctionInfo* pureInfo, std::vector<CommandValue>&& key,
+                            size_t transcriptStart, const CommandValue& result);
+    
+    // Load-time function index and parameter plans of user functions
+    void planFunctionParameters();
+    
+    // Pooled call frames of user functions
+    void planCallFrames();
+    size_t planExecutionStack() const;
+    size_t bodyStackDepth(const arduino_ast::ASTNode* node, std::unordered_set<std::string>& callees) const;
+    bool pushCallFrame(const arduino_ast::FuncDefNode* funcDef, const std::string& name);
+    CommandValue popCallFrame();
+    CommandValue& returnSlot() { return callDepth_ ? callFrames_[callDepth_ - 1].returnValue : returnValue_; }
+    
+    /** Releases the top frame when a call is left early or unwound by an exception */
+    struct CallFrameGuard {
+        ASTInterpreter* interpreter;
+        bool active = true;
+        ~CallFrameGuard() { if (active) interpreter->popCallFrame(); }
+    };
+    
+    // Switch dispatch
+    void buildSwitchTables(const arduino_ast::ASTNode* node);
+    SwitchDispatch analyzeSwitch(const arduino_ast::SwitchStatement* node);
+    int32_t findSwitchEntry(const SwitchDispatch& dispatch, const CommandValue& discriminant,
+                            std::vector<CommandValue>& scannedLabels);
+    bool executeSwitchCase(const arduino_ast::CaseStatement* caseNode);
+    
     // MEMORY SAFE: AST tree traversal to find function definitions
     arduino_ast::ASTNode* findFunctionInAST(const std::string& functionName);
 };
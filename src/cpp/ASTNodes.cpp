@@ -10,6 +10,7 @@
 
 #include "ASTNodes.hpp"
 #include <sstream>
+#include <functional>
 
 namespace arduino_ast {
 
@@ -219,6 +220,30 @@ void PointerDeclaratorNode::accept(ASTVisitor& visitor) {
     visitor.visit(*this);
 }
 
+void StructMemberNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+void MultipleStructMembersNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+void NewExpressionNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+void NamespaceAccessNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+void CppCastNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
+void FunctionStyleCastNode::accept(ASTVisitor& visitor) {
+    visitor.visit(*this);
+}
+
 // =============================================================================
 // UTILITY FUNCTIONS
 // =============================================================================
@@ -309,12 +334,18 @@ ASTNodePtr createNode(ASTNodeType type) {
             return std::make_unique<TypedefDeclaration>();
         case ASTNodeType::COMMA_EXPRESSION:
             return std::make_unique<CommaExpression>();
+        case ASTNodeType::NEW_EXPRESSION:
+            return std::make_unique<NewExpressionNode>();
         case ASTNodeType::STRUCT_TYPE:
             return std::make_unique<StructType>();
         case ASTNodeType::ARRAY_DECLARATOR:
             return std::make_unique<ArrayDeclaratorNode>();
         case ASTNodeType::POINTER_DECLARATOR:
             return std::make_unique<PointerDeclaratorNode>();
+        case ASTNodeType::STRUCT_MEMBER:
+            return std::make_unique<StructMemberNode>();
+        case ASTNodeType::MULTIPLE_STRUCT_MEMBERS:
+            return std::make_unique<MultipleStructMembersNode>();
         default:
             return nullptr;
     }
@@ -416,4 +447,185 @@ size_t estimateNodeMemoryUsage(const ASTNode* node) {
     return size;
 }
 
+void forEachChildNode(const ASTNode* node, const std::function<void(const ASTNode*)>& callback) {
+    if (!node) return;
+    
+    auto visitOne = [&callback](const ASTNode* child) {
+        if (child) callback(child);
+    };
+    auto visitAll = [&callback](const std::vector<ASTNodePtr>& children) {
+        for (const auto& child : children) {
+            if (child) callback(child.get());
+        }
+    };
+    
+    visitAll(node->getChildren());
+    
+    // Typed fields held outside the generic children vector
+    switch (node->getType()) {
+        case ASTNodeType::EXPRESSION_STMT:
+            if (const auto* n = dynamic_cast<const ExpressionStatement*>(node)) {
+                visitOne(n->getExpression());
+            }
+            break;
+        case ASTNodeType::IF_STMT:
+            if (const auto* n = dynamic_cast<const IfStatement*>(node)) {
+                visitOne(n->getCondition());
+                visitOne(n->getConsequent());
+                visitOne(n->getAlternate());
+            }
+            break;
+        case ASTNodeType::WHILE_STMT:
+            if (const auto* n = dynamic_cast<const WhileStatement*>(node)) {
+                visitOne(n->getCondition());
+                visitOne(n->getBody());
+            }
+            break;
+        case ASTNodeType::DO_WHILE_STMT:
+            if (const auto* n = dynamic_cast<const DoWhileStatement*>(node)) {
+                visitOne(n->getBody());
+                visitOne(n->getCondition());
+            }
+            break;
+        case ASTNodeType::FOR_STMT:
+            if (const auto* n = dynamic_cast<const ForStatement*>(node)) {
+                visitOne(n->getInitializer());
+                visitOne(n->getCondition());
+                visitOne(n->getIncrement());
+                visitOne(n->getBody());
+            }
+            break;
+        case ASTNodeType::RETURN_STMT:
+            if (const auto* n = dynamic_cast<const ReturnStatement*>(node)) {
+                visitOne(n->getReturnValue());
+            }
+            break;
+        case ASTNodeType::BINARY_OP:
+            if (const auto* n = dynamic_cast<const BinaryOpNode*>(node)) {
+                visitOne(n->getLeft());
+                visitOne(n->getRight());
+            }
+            break;
+        case ASTNodeType::UNARY_OP:
+            if (const auto* n = dynamic_cast<const UnaryOpNode*>(node)) {
+                visitOne(n->getOperand());
+            }
+            break;
+        case ASTNodeType::FUNC_CALL:
+            if (const auto* n = dynamic_cast<const FuncCallNode*>(node)) {
+                visitOne(n->getCallee());
+                visitAll(n->getArguments());
+            }
+            break;
+        case ASTNodeType::CONSTRUCTOR_CALL:
+            if (const auto* n = dynamic_cast<const ConstructorCallNode*>(node)) {
+                visitOne(n->getCallee());
+                visitAll(n->getArguments());
+            }
+            break;
+        case ASTNodeType::NEW_EXPRESSION:
+            if (const auto* n = dynamic_cast<const NewExpressionNode*>(node)) {
+                visitOne(n->getTypeSpecifier());
+                visitAll(n->getArguments());
+            }
+            break;
+        case ASTNodeType::MEMBER_ACCESS:
+            if (const auto* n = dynamic_cast<const MemberAccessNode*>(node)) {
+                visitOne(n->getObject());
+                visitOne(n->getProperty());
+            }
+            break;
+        case ASTNodeType::VAR_DECL:
+            if (const auto* n = dynamic_cast<const VarDeclNode*>(node)) {
+                visitOne(n->getVarType());
+                visitAll(n->getDeclarations());
+            }
+            break;
+        case ASTNodeType::FUNC_DEF:
+            if (const auto* n = dynamic_cast<const FuncDefNode*>(node)) {
+                visitOne(n->getReturnType());
+                visitOne(n->getDeclarator());
+                visitAll(n->getParameters());
+                visitOne(n->getBody());
+            }
+            break;
+        case ASTNodeType::PARAM_NODE:
+            if (const auto* n = dynamic_cast<const ParamNode*>(node)) {
+                visitOne(n->getParamType());
+                visitOne(n->getDeclarator());
+            }
+            break;
+        case ASTNodeType::ASSIGNMENT:
+            if (const auto* n = dynamic_cast<const AssignmentNode*>(node)) {
+                visitOne(n->getLeft());
+                visitOne(n->getRight());
+            }
+            break;
+        case ASTNodeType::POSTFIX_EXPRESSION:
+            if (const auto* n = dynamic_cast<const PostfixExpressionNode*>(node)) {
+                visitOne(n->getOperand());
+            }
+            break;
+        case ASTNodeType::SWITCH_STMT:
+            if (const auto* n = dynamic_cast<const SwitchStatement*>(node)) {
+                visitOne(n->getCondition());
+                visitOne(n->getBody());
+            }
+            break;
+        case ASTNodeType::CASE_STMT:
+            if (const auto* n = dynamic_cast<const CaseStatement*>(node)) {
+                visitOne(n->getLabel());
+                visitOne(n->getBody());
+            }
+            break;
+        case ASTNodeType::RANGE_FOR_STMT:
+            if (const auto* n = dynamic_cast<const RangeBasedForStatement*>(node)) {
+                visitOne(n->getVariable());
+                visitOne(n->getIterable());
+                visitOne(n->getBody());
+            }
+            break;
+        case ASTNodeType::ARRAY_ACCESS:
+            if (const auto* n = dynamic_cast<const ArrayAccessNode*>(node)) {
+                visitOne(n->getArray());
+                visitOne(n->getIndex());
+            }
+            break;
+        case ASTNodeType::TERNARY_EXPR:
+            if (const auto* n = dynamic_cast<const TernaryExpressionNode*>(node)) {
+                visitOne(n->getCondition());
+                visitOne(n->getTrueExpression());
+                visitOne(n->getFalseExpression());
+            }
+            break;
+        case ASTNodeType::CPP_CAST:
+            if (const auto* n = dynamic_cast<const CppCastNode*>(node)) {
+                visitOne(n->getTargetType());
+                visitOne(n->getExpression());
+            }
+            break;
+        case ASTNodeType::FUNCTION_STYLE_CAST:
+            if (const auto* n = dynamic_cast<const FunctionStyleCastNode*>(node)) {
+                visitOne(n->getCastType());
+                visitOne(n->getArgument());
+            }
+            break;
+        case ASTNodeType::NAMESPACE_ACCESS:
+            if (const auto* n = dynamic_cast<const NamespaceAccessNode*>(node)) {
+                visitOne(n->getNamespace());
+                visitOne(n->getMember());
+            }
+            break;
+        case ASTNodeType::ARRAY_DECLARATOR:
+            if (const auto* n = dynamic_cast<const ArrayDeclaratorNode*>(node)) {
+                visitOne(n->getIdentifier());
+                visitOne(n->getSize());
+                visitAll(n->getDimensions());
+            }
+            break;
+        default:
+            break;
+    }
+}
+
 } // namespace arduino_ast
\ No newline at end of file
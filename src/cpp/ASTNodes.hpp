@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cmath>
 #include <cstdint>
 #include <string>
 #include <iostream>
@@ -18,6 +19,7 @@
 #include <memory>
 #include <variant>
 #include <map>
+#include <functional>
 
 namespace arduino_ast {
 
@@ -225,6 +227,13 @@ public:
         return T{};
     }
     
+    /** String value by reference (literal text, names); empty when the value is not a string */
+    const std::string& getStringValue() const {
+        static const std::string empty;
+        const auto* text = std::get_if<std::string>(&value_);
+        return text ? *text : empty;
+    }
+    
     // Children management
     const ASTNodeVector& getChildren() const { return children_; }
     void addChild(ASTNodePtr child) { 
@@ -528,12 +537,17 @@ public:
 // =============================================================================
 
 class NumberNode : public ASTNode {
+private:
+    bool integer_;  // Integer constant in the source (no decimal point, exponent or f suffix)
+    
 public:
-    explicit NumberNode(double value) : ASTNode(ASTNodeType::NUMBER_LITERAL) {
+    explicit NumberNode(double value) : ASTNode(ASTNodeType::NUMBER_LITERAL), integer_(std::floor(value) == value) {
         setValue(value);
     }
     
     double getNumber() const { return getValueAs<double>(); }
+    bool isInteger() const { return integer_; }
+    void setInteger(bool integer) { integer_ = integer; }
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -543,7 +557,7 @@ public:
         setValue(value);
     }
     
-    std::string getString() const { return getValueAs<std::string>(); }
+    const std::string& getString() const { return getStringValue(); }
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -804,7 +818,7 @@ public:
         setValue(value);
     }
     
-    std::string getConstantValue() const { return getValueAs<std::string>(); }
+    const std::string& getConstantValue() const { return getStringValue(); }
     void accept(ASTVisitor& visitor) override;
 };
 
@@ -1355,6 +1369,12 @@ std::string valueTypeToString(ValueType type);
  */
 size_t estimateNodeMemoryUsage(const ASTNode* node);
 
+/**
+ * Invoke callback on every direct child of node: the generic children vector
+ * plus typed fields (conditions, bodies, parameters, declarations, ...)
+ */
+void forEachChildNode(const ASTNode* node, const std::function<void(const ASTNode*)>& callback);
+
 /**
  * Specialized factory functions for common nodes (for test compatibility)
  */
@@ -1,45 +1,14 @@
 #include "ArduinoDataTypes.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 
 namespace arduino_interpreter {
 
-// =============================================================================
-// ARDUINO STRUCT IMPLEMENTATION
-// =============================================================================
-
-ArduinoStruct::ArduinoStruct(const std::string& typeName) : typeName_(typeName) {
-}
-
-bool ArduinoStruct::hasMember(const std::string& name) const {
-    return members_.find(name) != members_.end();
-}
-
-EnhancedCommandValue ArduinoStruct::getMember(const std::string& name) const {
-    auto it = members_.find(name);
-    if (it != members_.end()) {
-        return it->second;
-    }
-    return std::monostate{}; // Return undefined for non-existent members
-}
-
-void ArduinoStruct::setMember(const std::string& name, const EnhancedCommandValue& value) {
-    members_[name] = value;
-}
-
-std::string ArduinoStruct::toString() const {
-    std::ostringstream oss;
-    oss << typeName_ << " { ";
-    bool first = true;
-    for (const auto& [name, value] : members_) {
-        if (!first) oss << ", ";
-        oss << name << ": " << enhancedCommandValueToString(value);
-        first = false;
-    }
-    oss << " }";
-    return oss.str();
-}
-
 // =============================================================================
 // ARDUINO POINTER IMPLEMENTATION
 // =============================================================================
@@ -85,78 +54,259 @@ std::string ArduinoPointer::toString() const {
 // ARDUINO ARRAY IMPLEMENTATION
 // =============================================================================
 
+namespace {
+
+/** Numeric payload of a value stored into a typed array */
+double numericElementValue(const EnhancedCommandValue& value, ArduinoArray::ElementKind kind) {
+    switch (value.index()) {
+        case 0: return 0.0;
+        case 1: return std::get<bool>(value) ? 1.0 : 0.0;
+        case 2: return std::get<int32_t>(value);
+        case 3: return std::get<double>(value);
+        case 4: {
+            const auto& text = std::get<std::string>(value);
+            if (kind == ArduinoArray::ElementKind::CHAR && text.size() <= 1) {
+                return text.empty() ? 0.0 : static_cast<double>(static_cast<unsigned char>(text[0]));
+            }
+            break;
+        }
+        default: break;
+    }
+    throw std::invalid_argument("Cannot store " + enhancedCommandValueToString(value) + " in a typed array");
+}
+
+/** Convert to T with C semantics: integers truncate and wrap modulo 2^N */
+template<typename T>
+T toElement(double numeric) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return numeric != 0.0;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(numeric);
+    } else {
+        if (!std::isfinite(numeric)) return T(0);
+        return static_cast<T>(static_cast<int64_t>(numeric));
+    }
+}
+
+} // anonymous namespace
+
+size_t ArduinoArray::elementSizeOf(ElementKind kind) {
+    if (kind == ElementKind::VARIANT) return 0;
+    return withElementType(kind, [](auto* tag) { return sizeof(*tag); });
+}
+
+EnhancedCommandValue ArduinoArray::loadElement(ElementKind kind, const uint8_t* at) {
+    return withElementType(kind, [at](auto* tag) {
+        using T = std::remove_pointer_t<decltype(tag)>;
+        T element;
+        std::memcpy(&element, at, sizeof(T));
+        return box(element);
+    });
+}
+
+void ArduinoArray::storeElement(ElementKind kind, uint8_t* at, const EnhancedCommandValue& value) {
+    double numeric = numericElementValue(value, kind);
+    withElementType(kind, [&](auto* tag) {
+        using T = std::remove_pointer_t<decltype(tag)>;
+        T element = toElement<T>(numeric);
+        std::memcpy(at, &element, sizeof(T));
+    });
+}
+
 ArduinoArray::ArduinoArray(const std::string& elementType, 
-                           const std::vector<size_t>& dimensions) 
-    : elementType_(elementType), dimensions_(dimensions) {
+                           const std::vector<size_t>& dimensions,
+                           ElementKind kind,
+                           SimulatedMemory* memory) 
+    : elementType_(elementType), size_(0), kind_(kind),
+      elementSize_(static_cast<uint8_t>(elementSizeOf(kind))) {
+    updateShape(dimensions);
+    
+    // Typed storage is value-initialized, i.e. zero-filled like a C array
+    if (isTyped()) {
+        bytes_ = MemoryBlock(memory, size_ * elementSize_);
+    } else {
+        elements_.resize(size_);
+    }
+}
+
+void ArduinoArray::updateShape(const std::vector<size_t>& dimensions) {
+    dimensions_ = dimensions;
+    strides_.assign(dimensions_.size(), 1);
     
-    // Calculate total size for multi-dimensional arrays
+    // Calculate total size and row-major strides for multi-dimensional arrays
     size_t totalSize = 1;
-    for (size_t dim : dimensions_) {
-        totalSize *= dim;
+    for (size_t i = dimensions_.size(); i-- > 0;) {
+        strides_[i] = totalSize;
+        totalSize *= dimensions_[i];
     }
-    elements_.resize(totalSize);
+    size_ = totalSize;
 }
 
 EnhancedCommandValue ArduinoArray::getElement(size_t index) const {
-    if (index >= elements_.size()) {
+    if (index >= size_) {
         throw std::out_of_range("Array index out of bounds");
     }
-    return elements_[index];
+    if (!isTyped()) {
+        return elements_[index];
+    }
+    return withElementType(kind_, [&](auto* tag) {
+        using T = std::remove_pointer_t<decltype(tag)>;
+        return box(reinterpret_cast<const T*>(bytes_.data())[index]);
+    });
 }
 
 void ArduinoArray::setElement(size_t index, const EnhancedCommandValue& value) {
-    if (index >= elements_.size()) {
+    if (index >= size_) {
         throw std::out_of_range("Array index out of bounds");
     }
-    elements_[index] = value;
+    if (!isTyped()) {
+        elements_[index] = value;
+        return;
+    }
+    double numeric = numericElementValue(value, kind_);
+    withElementType(kind_, [&](auto* tag) {
+        using T = std::remove_pointer_t<decltype(tag)>;
+        reinterpret_cast<T*>(bytes_.data())[index] = toElement<T>(numeric);
+    });
 }
 
 EnhancedCommandValue ArduinoArray::getElement(const std::vector<size_t>& indices) const {
-    size_t flatIndex = 0;
-    size_t multiplier = 1;
-    
-    // Convert multi-dimensional indices to flat index
-    for (int i = dimensions_.size() - 1; i >= 0; --i) {
-        if (i >= (int)indices.size() || indices[i] >= dimensions_[i]) {
-            throw std::out_of_range("Multi-dimensional array index out of bounds");
-        }
-        flatIndex += indices[i] * multiplier;
-        multiplier *= dimensions_[i];
-    }
-    
-    return getElement(flatIndex);
+    return getElement(flatIndex(indices.data(), indices.size()));
 }
 
 void ArduinoArray::setElement(const std::vector<size_t>& indices, const EnhancedCommandValue& value) {
-    size_t flatIndex = 0;
-    size_t multiplier = 1;
-    
-    // Convert multi-dimensional indices to flat index
-    for (int i = dimensions_.size() - 1; i >= 0; --i) {
-        if (i >= (int)indices.size() || indices[i] >= dimensions_[i]) {
+    setElement(flatIndex(indices.data(), indices.size()), value);
+}
+
+size_t ArduinoArray::flatIndex(const size_t* indices, size_t count) const {
+    if (count != dimensions_.size()) {
+        throw std::out_of_range("Multi-dimensional array index out of bounds");
+    }
+    size_t flat = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (indices[i] >= dimensions_[i]) {
             throw std::out_of_range("Multi-dimensional array index out of bounds");
         }
-        flatIndex += indices[i] * multiplier;
-        multiplier *= dimensions_[i];
+        flat += indices[i] * strides_[i];
     }
-    
-    setElement(flatIndex, value);
+    return flat;
 }
 
 void ArduinoArray::resize(size_t newSize, const EnhancedCommandValue& defaultValue) {
-    elements_.resize(newSize, defaultValue);
+    size_t oldSize = size_;
+    if (dimensions_.size() > 1 && strides_[0] > 0 && newSize % strides_[0] == 0) {
+        // Whole rows: grow or shrink the outermost dimension, keep the row shape
+        std::vector<size_t> newDimensions = dimensions_;
+        newDimensions[0] = newSize / strides_[0];
+        updateShape(newDimensions);
+    } else {
+        // A partial row no longer has a rectangular shape; view it as one dimension
+        updateShape({newSize});
+    }
+    
+    if (!isTyped()) {
+        elements_.resize(newSize, defaultValue);
+        return;
+    }
+    bytes_.resize(newSize * elementSize_);
+    if (newSize > oldSize && defaultValue.index() != 0) {
+        fill(oldSize, newSize - oldSize, defaultValue);
+    }
 }
 
 void ArduinoArray::resizeMultiDimensional(const std::vector<size_t>& newDimensions, const EnhancedCommandValue& defaultValue) {
-    dimensions_ = newDimensions;
+    size_t oldSize = size_;
+    updateShape(newDimensions);
     
-    // Calculate total size for new dimensions
-    size_t totalSize = 1;
-    for (size_t dim : dimensions_) {
-        totalSize *= dim;
+    if (!isTyped()) {
+        elements_.resize(size_, defaultValue);
+        return;
     }
+    bytes_.resize(size_ * elementSize_);
+    if (size_ > oldSize && defaultValue.index() != 0) {
+        fill(oldSize, size_ - oldSize, defaultValue);
+    }
+}
+
+void ArduinoArray::fill(const EnhancedCommandValue& value) {
+    fill(0, size_, value);
+}
+
+void ArduinoArray::fill(size_t first, size_t count, const EnhancedCommandValue& value) {
+    if (first >= size_) return;
+    count = std::min(count, size_ - first);
     
-    elements_.resize(totalSize, defaultValue);
+    if (!isTyped()) {
+        std::fill_n(elements_.begin() + first, count, value);
+        return;
+    }
+    
+    double numeric = numericElementValue(value, kind_);
+    withElementType(kind_, [&](auto* tag) {
+        using T = std::remove_pointer_t<decltype(tag)>;
+        T element = toElement<T>(numeric);
+        T* elements = reinterpret_cast<T*>(bytes_.data()) + first;
+        
+        // All-zero (and other single-byte pattern) fills are a memset; the rest
+        // is a plain loop over T the compiler vectorizes
+        uint8_t pattern[sizeof(T)];
+        std::memcpy(pattern, &element, sizeof(T));
+        if (std::all_of(pattern, pattern + sizeof(T), [&](uint8_t b) { return b == pattern[0]; })) {
+            std::memset(elements, pattern[0], count * sizeof(T));
+        } else {
+            std::fill_n(elements, count, element);
+        }
+    });
+}
+
+void ArduinoArray::zero() {
+    if (isTyped()) {
+        std::memset(bytes_.data(), 0, bytes_.size());
+    } else {
+        std::fill(elements_.begin(), elements_.end(), EnhancedCommandValue(int32_t(0)));
+    }
+}
+
+size_t ArduinoArray::setBytes(size_t offset, uint8_t value, size_t count) {
+    if (offset >= bytes_.size()) return 0;
+    count = std::min(count, bytes_.size() - offset);
+    std::memset(bytes_.data() + offset, value, count);
+    return count;
+}
+
+size_t ArduinoArray::copyBytes(size_t offset, const ArduinoArray& source, size_t count) {
+    if (offset >= bytes_.size()) return 0;
+    count = std::min({count, bytes_.size() - offset, source.bytes_.size()});
+    
+    // memmove: source may be this array
+    std::memmove(bytes_.data() + offset, source.bytes_.data(), count);
+    return count;
+}
+
+size_t ArduinoArray::copyBytes(size_t offset, std::string_view source) {
+    if (offset >= bytes_.size()) return 0;
+    size_t count = std::min(source.size(), bytes_.size() - offset);
+    std::memmove(bytes_.data() + offset, source.data(), count);
+    return count;
+}
+
+bool ArduinoArray::isCharBuffer() const {
+    return kind_ == ElementKind::CHAR || kind_ == ElementKind::INT8 || kind_ == ElementKind::UINT8;
+}
+
+std::string_view ArduinoArray::cString(size_t offset) const {
+    if (!isCharBuffer() || offset >= bytes_.size()) return {};
+    const char* start = reinterpret_cast<const char*>(bytes_.data()) + offset;
+    const void* end = std::memchr(start, 0, bytes_.size() - offset);
+    return std::string_view(start, end ? static_cast<const char*>(end) - start : bytes_.size() - offset);
+}
+
+size_t ArduinoArray::storeCString(size_t offset, std::string_view text) {
+    if (!isCharBuffer() || offset >= bytes_.size()) return 0;
+    size_t count = std::min(text.size(), bytes_.size() - offset - 1);
+    std::memmove(bytes_.data() + offset, text.data(), count);
+    bytes_[offset + count] = 0;
+    return count;
 }
 
 size_t ArduinoArray::getDimensionSize(size_t dimensionIndex) const {
@@ -184,21 +334,11 @@ size_t ArduinoArray::calculateFlatIndex(const std::vector<size_t>& indices) cons
     if (!isValidIndices(indices)) {
         throw std::out_of_range("Invalid multi-dimensional array indices");
     }
-    
-    size_t flatIndex = 0;
-    size_t multiplier = 1;
-    
-    // Convert multi-dimensional indices to flat index
-    for (int i = dimensions_.size() - 1; i >= 0; --i) {
-        flatIndex += indices[i] * multiplier;
-        multiplier *= dimensions_[i];
-    }
-    
-    return flatIndex;
+    return flatIndex(indices.data(), indices.size());
 }
 
 std::vector<size_t> ArduinoArray::calculateMultiDimensionalIndex(size_t flatIndex) const {
-    if (flatIndex >= elements_.size()) {
+    if (flatIndex >= size_) {
         throw std::out_of_range("Flat index out of bounds for multi-dimensional array");
     }
     
@@ -221,12 +361,167 @@ std::string ArduinoArray::toString() const {
     }
     oss << "] { ";
     
-    for (size_t i = 0; i < std::min(elements_.size(), size_t(5)); ++i) {
+    for (size_t i = 0; i < std::min(size_, size_t(5)); ++i) {
         if (i > 0) oss << ", ";
-        oss << enhancedCommandValueToString(elements_[i]);
+        oss << enhancedCommandValueToString(getElement(i));
+    }
+    if (size_ > 5) {
+        oss << ", ... (" << size_ << " total)";
+    }
+    oss << " }";
+    return oss.str();
+}
+
+// =============================================================================
+// ARDUINO STRUCT IMPLEMENTATION
+// =============================================================================
+
+namespace {
+
+/** Independent copy of a slot member (nested structs share their record until written) */
+EnhancedCommandValue cloneMember(const EnhancedCommandValue& value) {
+    if (const auto* nested = std::get_if<Ref<ArduinoStruct>>(&value)) {
+        if (*nested) return makeRef<ArduinoStruct>(**nested);
+    } else if (const auto* array = std::get_if<Ref<ArduinoArray>>(&value)) {
+        if (*array) return makeRef<ArduinoArray>(**array);
+    } else if (const auto* text = std::get_if<Ref<ArduinoString>>(&value)) {
+        if (*text) return makeRef<ArduinoString>(**text);
+    }
+    return value;
+}
+
+} // anonymous namespace
+
+void StructLayout::addField(const std::string& name, const std::string& type, ArduinoArray::ElementKind kind,
+                            const EnhancedCommandValue& initial, uint32_t maxAlignment) {
+    Field field;
+    field.name = name;
+    field.typeName = type;
+    field.kind = kind;
+    field.initial = initial;
+    
+    if (field.isPacked()) {
+        uint32_t size = static_cast<uint32_t>(ArduinoArray::elementSizeOf(kind));
+        uint32_t align = std::max<uint32_t>(1, std::min(size, maxAlignment));
+        byteSize = (byteSize + align - 1) / align * align;
+        field.offset = byteSize;
+        byteSize += size;
+        alignment = std::max(alignment, align);
+    } else {
+        field.offset = objectSlots++;
+    }
+    fields.push_back(std::move(field));
+}
+
+void StructLayout::finish() {
+    byteSize = (byteSize + alignment - 1) / alignment * alignment;
+}
+
+int32_t StructLayout::fieldIndex(const std::string& name) const {
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (fields[i].name == name) return static_cast<int32_t>(i);
     }
-    if (elements_.size() > 5) {
-        oss << ", ... (" << elements_.size() << " total)";
+    return -1;
+}
+
+ArduinoStruct::ArduinoStruct(const std::string& typeName) : storage_(makeRef<Storage>()) {
+    auto layout = makeRef<StructLayout>(typeName);
+    layout->open = true;
+    layout_ = std::move(layout);
+}
+
+ArduinoStruct::ArduinoStruct(Ref<const StructLayout> layout)
+    : layout_(std::move(layout)), storage_(makeRef<Storage>()) {
+    // Packed members start zeroed, like a C struct with static storage
+    storage_->bytes.resize(layout_->byteSize);
+    storage_->objects.reserve(layout_->objectSlots);
+    for (const auto& field : layout_->fields) {
+        if (!field.isPacked()) {
+            storage_->objects.push_back(cloneMember(field.initial));
+        }
+    }
+}
+
+void ArduinoStruct::detach() {
+    if (storage_->refCount() > 1) {
+        auto own = makeRef<Storage>();
+        own->bytes = storage_->bytes;
+        own->objects.reserve(storage_->objects.size());
+        for (const auto& object : storage_->objects) {
+            own->objects.push_back(cloneMember(object));
+        }
+        storage_ = std::move(own);
+    }
+}
+
+bool ArduinoStruct::hasMember(const std::string& name) const {
+    return layout_->fieldIndex(name) >= 0;
+}
+
+EnhancedCommandValue ArduinoStruct::getMember(const std::string& name) const {
+    int32_t index = layout_->fieldIndex(name);
+    if (index >= 0) {
+        return getField(static_cast<size_t>(index));
+    }
+    return std::monostate{}; // Return undefined for non-existent members
+}
+
+void ArduinoStruct::setMember(const std::string& name, const EnhancedCommandValue& value) {
+    int32_t index = layout_->fieldIndex(name);
+    if (index < 0) {
+        if (!layout_->open) {
+            throw std::invalid_argument("'" + layout_->typeName + "' has no member named '" + name + "'");
+        }
+        // Ad-hoc objects take a new slot member per name
+        detach();
+        auto grown = makeRef<StructLayout>(*layout_);
+        grown->addField(name, "", ArduinoArray::ElementKind::VARIANT);
+        layout_ = std::move(grown);
+        storage_->objects.emplace_back(std::monostate{});
+        index = static_cast<int32_t>(layout_->fields.size() - 1);
+    }
+    setField(static_cast<size_t>(index), value);
+}
+
+EnhancedCommandValue ArduinoStruct::getField(size_t index) const {
+    const auto& field = layout_->fields.at(index);
+    if (field.isPacked()) {
+        return ArduinoArray::loadElement(field.kind, storage_->bytes.data() + field.offset);
+    }
+    return storage_->objects[field.offset];
+}
+
+void ArduinoStruct::setField(size_t index, const EnhancedCommandValue& value) {
+    const auto& field = layout_->fields.at(index);
+    detach();
+    if (field.isPacked()) {
+        ArduinoArray::storeElement(field.kind, storage_->bytes.data() + field.offset, value);
+    } else {
+        storage_->objects[field.offset] = cloneMember(value);  // Copied in, never aliased
+    }
+}
+
+const ArduinoStruct* ArduinoStruct::structField(size_t index) const {
+    const auto& field = layout_->fields.at(index);
+    if (field.isPacked()) return nullptr;
+    const auto* nested = std::get_if<Ref<ArduinoStruct>>(&storage_->objects[field.offset]);
+    return nested ? nested->get() : nullptr;
+}
+
+ArduinoStruct* ArduinoStruct::mutableStructField(size_t index) {
+    const auto& field = layout_->fields.at(index);
+    if (field.isPacked()) return nullptr;
+    detach();
+    auto* nested = std::get_if<Ref<ArduinoStruct>>(&storage_->objects[field.offset]);
+    return nested ? nested->get() : nullptr;
+}
+
+std::string ArduinoStruct::toString() const {
+    std::ostringstream oss;
+    oss << layout_->typeName << " { ";
+    for (size_t i = 0; i < layout_->fields.size(); ++i) {
+        if (i > 0) oss << ", ";
+        oss << layout_->fields[i].name << ": " << enhancedCommandValueToString(getField(i));
     }
     oss << " }";
     return oss.str();
@@ -239,11 +534,27 @@ std::string ArduinoArray::toString() const {
 ArduinoString::ArduinoString(const std::string& str) : data_(str) {
 }
 
-char ArduinoString::charAt(size_t index) const {
-    if (index >= data_.length()) {
-        return '\0';  // Arduino String behavior
+bool ArduinoString::reserve(size_t size) {
+    // Arduino only ever grows the buffer, and reports whether it could
+    if (data_.capacity() >= size) {
+        return true;
     }
-    return data_[index];
+    try {
+        data_.reserve(size);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+bool ArduinoString::concat(const std::string& text) {
+    data_ += text;
+    return true;
+}
+
+bool ArduinoString::concat(char c) {
+    data_ += c;
+    return true;
 }
 
 void ArduinoString::setCharAt(size_t index, char c) {
@@ -252,75 +563,165 @@ void ArduinoString::setCharAt(size_t index, char c) {
     }
 }
 
-ArduinoString ArduinoString::substring(size_t start, size_t end) const {
+char ArduinoStringView::charAt(size_t index) const {
+    if (index >= data_.length()) {
+        return '\0';  // Arduino String behavior
+    }
+    return data_[index];
+}
+
+ArduinoString ArduinoStringView::substring(size_t start, size_t end) const {
     if (end == std::string::npos) {
         end = data_.length();
     }
+    if (start > end) {
+        std::swap(start, end);  // Arduino accepts the bounds in either order
+    }
     if (start >= data_.length()) {
-        return ArduinoString("");
+        return ArduinoString();
     }
     if (end > data_.length()) {
         end = data_.length();
     }
-    if (start >= end) {
-        return ArduinoString("");
-    }
     return ArduinoString(data_.substr(start, end - start));
 }
 
-int ArduinoString::indexOf(const std::string& str, size_t start) const {
+int ArduinoStringView::indexOf(const std::string& str, size_t start) const {
+    if (start >= data_.length()) {
+        return -1;
+    }
     size_t pos = data_.find(str, start);
     return (pos == std::string::npos) ? -1 : static_cast<int>(pos);
 }
 
-int ArduinoString::lastIndexOf(const std::string& str, size_t start) const {
+int ArduinoStringView::lastIndexOf(const std::string& str, size_t start) const {
     size_t pos = data_.rfind(str, start);
     return (pos == std::string::npos) ? -1 : static_cast<int>(pos);
 }
 
-bool ArduinoString::startsWith(const std::string& str) const {
-    return data_.substr(0, str.length()) == str;
+bool ArduinoStringView::startsWith(const std::string& str) const {
+    return str.length() <= data_.length() && data_.compare(0, str.length(), str) == 0;
 }
 
-bool ArduinoString::endsWith(const std::string& str) const {
-    if (str.length() > data_.length()) return false;
-    return data_.substr(data_.length() - str.length()) == str;
+bool ArduinoStringView::endsWith(const std::string& str) const {
+    return str.length() <= data_.length() &&
+           data_.compare(data_.length() - str.length(), str.length(), str) == 0;
 }
 
-ArduinoString ArduinoString::toLowerCase() const {
-    std::string result = data_;
-    for (char& c : result) {
-        c = std::tolower(c);
+bool ArduinoStringView::equalsIgnoreCase(const std::string& str) const {
+    if (str.length() != data_.length()) {
+        return false;
     }
-    return ArduinoString(result);
+    for (size_t i = 0; i < data_.length(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(data_[i])) != std::tolower(static_cast<unsigned char>(str[i]))) {
+            return false;
+        }
+    }
+    return true;
 }
 
-ArduinoString ArduinoString::toUpperCase() const {
-    std::string result = data_;
-    for (char& c : result) {
-        c = std::toupper(c);
+int ArduinoStringView::compareTo(const std::string& str) const {
+    // strcmp() semantics: difference of the first differing characters
+    size_t common = std::min(data_.length(), str.length());
+    for (size_t i = 0; i < common; ++i) {
+        if (data_[i] != str[i]) {
+            return static_cast<unsigned char>(data_[i]) - static_cast<unsigned char>(str[i]);
+        }
+    }
+    if (data_.length() == str.length()) {
+        return 0;
     }
-    return ArduinoString(result);
+    return data_.length() > str.length() ? static_cast<unsigned char>(data_[common])
+                                         : -static_cast<int>(static_cast<unsigned char>(str[common]));
 }
 
-int ArduinoString::toInt() const {
-    try {
-        return std::stoi(data_);
-    } catch (...) {
-        return 0;  // Arduino String behavior
+void ArduinoString::toLowerCase() {
+    for (char& c : data_) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
     }
 }
 
-double ArduinoString::toFloat() const {
-    try {
-        return std::stod(data_);
-    } catch (...) {
-        return 0.0;  // Arduino String behavior
+void ArduinoString::toUpperCase() {
+    for (char& c : data_) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
     }
 }
 
+void ArduinoString::trim() {
+    const char* whitespace = " \t\n\r\f\v";
+    size_t end = data_.find_last_not_of(whitespace);
+    if (end == std::string::npos) {
+        data_.clear();  // String is all whitespace
+        return;
+    }
+    data_.erase(end + 1);
+    data_.erase(0, data_.find_first_not_of(whitespace));
+}
+
+void ArduinoString::replace(const std::string& find, const std::string& replacement) {
+    if (find.empty()) {
+        return;
+    }
+    
+    // Same length or shorter: rewrite the buffer in place
+    if (replacement.length() <= find.length()) {
+        size_t read = 0;
+        size_t write = 0;
+        for (size_t pos; (pos = data_.find(find, read)) != std::string::npos; read = pos + find.length()) {
+            std::memmove(&data_[write], data_.data() + read, pos - read);
+            write += pos - read;
+            std::memcpy(&data_[write], replacement.data(), replacement.length());
+            write += replacement.length();
+        }
+        std::memmove(&data_[write], data_.data() + read, data_.length() - read);
+        data_.resize(write + data_.length() - read);
+        return;
+    }
+    
+    // Longer: size the result once
+    size_t matches = 0;
+    for (size_t pos = data_.find(find); pos != std::string::npos; pos = data_.find(find, pos + find.length())) {
+        ++matches;
+    }
+    if (matches == 0) {
+        return;
+    }
+    std::string result;
+    result.reserve(data_.length() + matches * (replacement.length() - find.length()));
+    size_t read = 0;
+    for (size_t pos; (pos = data_.find(find, read)) != std::string::npos; read = pos + find.length()) {
+        result.append(data_, read, pos - read);
+        result += replacement;
+    }
+    result.append(data_, read, std::string::npos);
+    data_.swap(result);
+}
+
+void ArduinoString::remove(size_t index, size_t count) {
+    if (index < data_.length()) {
+        data_.erase(index, count);
+    }
+}
+
+ArduinoString ArduinoString::substring(size_t start, size_t end) const {
+    return view().substring(start, end);
+}
+
+int ArduinoStringView::toInt() const {
+    // atol(): leading digits, 0 when there are none
+    return static_cast<int>(std::strtol(data_.c_str(), nullptr, 10));
+}
+
+double ArduinoStringView::toFloat() const {
+    return std::strtod(data_.c_str(), nullptr);
+}
+
 ArduinoString ArduinoString::operator+(const ArduinoString& other) const {
-    return ArduinoString(data_ + other.data_);
+    ArduinoString result;
+    result.data_.reserve(data_.length() + other.data_.length());
+    result.data_ += data_;
+    result.data_ += other.data_;
+    return result;
 }
 
 ArduinoString& ArduinoString::operator+=(const ArduinoString& other) {
@@ -333,33 +734,6 @@ ArduinoString& ArduinoString::operator+=(const std::string& other) {
     return *this;
 }
 
-ArduinoString ArduinoString::trim() const {
-    std::string result = data_;
-    
-    // Trim leading whitespace
-    size_t start = result.find_first_not_of(" \t\n\r\f\v");
-    if (start == std::string::npos) {
-        return ArduinoString("");  // String is all whitespace
-    }
-    
-    // Trim trailing whitespace
-    size_t end = result.find_last_not_of(" \t\n\r\f\v");
-    
-    return ArduinoString(result.substr(start, end - start + 1));
-}
-
-ArduinoString ArduinoString::replace(const std::string& find, const std::string& replace) const {
-    std::string result = data_;
-    size_t pos = 0;
-    
-    while ((pos = result.find(find, pos)) != std::string::npos) {
-        result.replace(pos, find.length(), replace);
-        pos += replace.length();
-    }
-    
-    return ArduinoString(result);
-}
-
 bool ArduinoString::operator==(const ArduinoString& other) const {
     return data_ == other.data_;
 }
@@ -384,6 +758,19 @@ bool ArduinoString::operator>=(const ArduinoString& other) const {
     return data_ >= other.data_;
 }
 
+void StringRope::flattenInto(std::string& out) const {
+    out.reserve(out.length() + length_);
+    for (size_t i = 0; i < count_; ++i) {
+        out.append(pieces_[i].data(), pieces_[i].size());
+    }
+}
+
+std::string StringRope::flatten() const {
+    std::string result;
+    flattenInto(result);
+    return result;
+}
+
 // =============================================================================
 // UTILITY FUNCTION IMPLEMENTATIONS
 // =============================================================================
@@ -405,13 +792,17 @@ std::variant<std::monostate, bool, int32_t, double, std::string> downgradeComman
             return arg;  // Direct conversion for basic types
         } else {
             // Convert complex types to strings
-            if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoStruct>>) {
+            if constexpr (std::is_same_v<T, Ref<ArduinoStruct>>) {
                 return arg ? arg->toString() : std::string("null_struct");
-            } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoString>>) {
+            } else if constexpr (std::is_same_v<T, Ref<ArduinoString>>) {
                 return arg ? arg->c_str() : std::string("");
-            } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoArray>>) {
+            } else if constexpr (std::is_same_v<T, Ref<ArduinoArray>>) {
+                // A char array reads as the C string it holds, like a char* in C
+                if (arg && arg->getElementKind() == ArduinoArray::ElementKind::CHAR) {
+                    return std::string(arg->cString());
+                }
                 return arg ? arg->toString() : std::string("null_array");
-            } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoPointer>>) {
+            } else if constexpr (std::is_same_v<T, Ref<ArduinoPointer>>) {
                 return arg ? arg->toString() : std::string("null_pointer");
             } else {
                 return std::string("unknown_type");
@@ -421,19 +812,19 @@ std::variant<std::monostate, bool, int32_t, double, std::string> downgradeComman
 }
 
 bool isStructType(const EnhancedCommandValue& value) {
-    return std::holds_alternative<std::shared_ptr<ArduinoStruct>>(value);
+    return std::holds_alternative<Ref<ArduinoStruct>>(value);
 }
 
 bool isPointerType(const EnhancedCommandValue& value) {
-    return std::holds_alternative<std::shared_ptr<ArduinoPointer>>(value);
+    return std::holds_alternative<Ref<ArduinoPointer>>(value);
 }
 
 bool isArrayType(const EnhancedCommandValue& value) {
-    return std::holds_alternative<std::shared_ptr<ArduinoArray>>(value);
+    return std::holds_alternative<Ref<ArduinoArray>>(value);
 }
 
 bool isStringType(const EnhancedCommandValue& value) {
-    return std::holds_alternative<std::shared_ptr<ArduinoString>>(value);
+    return std::holds_alternative<Ref<ArduinoString>>(value);
 }
 
 std::string enhancedCommandValueToString(const EnhancedCommandValue& value) {
@@ -449,13 +840,13 @@ std::string enhancedCommandValueToString(const EnhancedCommandValue& value) {
             return std::to_string(arg);
         } else if constexpr (std::is_same_v<T, std::string>) {
             return "\"" + arg + "\"";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoStruct>>) {
+        } else if constexpr (std::is_same_v<T, Ref<ArduinoStruct>>) {
             return arg ? arg->toString() : "null_struct";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoString>>) {
+        } else if constexpr (std::is_same_v<T, Ref<ArduinoString>>) {
             return arg ? ("\"" + arg->c_str() + "\"") : "null_string";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoArray>>) {
+        } else if constexpr (std::is_same_v<T, Ref<ArduinoArray>>) {
             return arg ? arg->toString() : "null_array";
-        } else if constexpr (std::is_same_v<T, std::shared_ptr<ArduinoPointer>>) {
+        } else if constexpr (std::is_same_v<T, Ref<ArduinoPointer>>) {
             return arg ? arg->toString() : "null_pointer";
         } else {
             return "unknown_type";
@@ -463,16 +854,21 @@ std::string enhancedCommandValueToString(const EnhancedCommandValue& value) {
     }, value);
 }
 
-std::shared_ptr<ArduinoStruct> createStruct(const std::string& typeName) {
-    return std::make_shared<ArduinoStruct>(typeName);
+Ref<ArduinoStruct> createStruct(const std::string& typeName) {
+    return makeRef<ArduinoStruct>(typeName);
+}
+
+Ref<ArduinoStruct> createStruct(Ref<const StructLayout> layout) {
+    return makeRef<ArduinoStruct>(std::move(layout));
 }
 
-std::shared_ptr<ArduinoArray> createArray(const std::string& elementType, const std::vector<size_t>& dimensions) {
-    return std::make_shared<ArduinoArray>(elementType, dimensions);
+Ref<ArduinoArray> createArray(const std::string& elementType, const std::vector<size_t>& dimensions,
+                                          ArduinoArray::ElementKind kind, SimulatedMemory* memory) {
+    return makeRef<ArduinoArray>(elementType, dimensions, kind, memory);
 }
 
-std::shared_ptr<ArduinoString> createString(const std::string& initialValue) {
-    return std::make_shared<ArduinoString>(initialValue);
+Ref<ArduinoString> createString(const std::string& initialValue) {
+    return makeRef<ArduinoString>(initialValue);
 }
 
 } // namespace arduino_interpreter
\ No newline at end of file
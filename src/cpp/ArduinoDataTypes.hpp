@@ -1,10 +1,16 @@
 #pragma once
 
+#include "RefCounted.hpp"
+#include "SimulatedMemory.hpp"
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <variant>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
 
 // Forward declarations
 namespace arduino_interpreter {
@@ -16,53 +22,26 @@ namespace arduino_interpreter {
 
 // Enhanced CommandValue that will replace the basic variant
 // This will include the new data model classes
+// Objects are held through non-atomic intrusive handles (see RefCounted.hpp)
 using EnhancedCommandValue = std::variant<
     std::monostate,                                          // void/undefined
     bool,                                                    // boolean
     int32_t,                                                // integer
     double,                                                  // floating point
     std::string,                                            // basic string
-    std::shared_ptr<arduino_interpreter::ArduinoStruct>,   // struct/object
-    std::shared_ptr<arduino_interpreter::ArduinoPointer>,  // pointer
-    std::shared_ptr<arduino_interpreter::ArduinoString>,   // enhanced string
-    std::shared_ptr<arduino_interpreter::ArduinoArray>     // array
+    arduino_interpreter::Ref<arduino_interpreter::ArduinoStruct>,   // struct/object
+    arduino_interpreter::Ref<arduino_interpreter::ArduinoPointer>,  // pointer
+    arduino_interpreter::Ref<arduino_interpreter::ArduinoString>,   // enhanced string
+    arduino_interpreter::Ref<arduino_interpreter::ArduinoArray>     // array
 >;
 
 namespace arduino_interpreter {
 
-// =============================================================================
-// ARDUINO STRUCT CLASS - For struct/object member access
-// =============================================================================
-
-class ArduinoStruct {
-private:
-    std::unordered_map<std::string, EnhancedCommandValue> members_;
-    std::string typeName_;
-
-public:
-    explicit ArduinoStruct(const std::string& typeName = "struct");
-    
-    // Member access
-    bool hasMember(const std::string& name) const;
-    EnhancedCommandValue getMember(const std::string& name) const;
-    void setMember(const std::string& name, const EnhancedCommandValue& value);
-    
-    // Type information
-    const std::string& getTypeName() const { return typeName_; }
-    void setTypeName(const std::string& typeName) { typeName_ = typeName; }
-    
-    // Iteration over members
-    const std::unordered_map<std::string, EnhancedCommandValue>& getMembers() const { return members_; }
-    
-    // Debug/serialization
-    std::string toString() const;
-};
-
 // =============================================================================
 // ARDUINO POINTER CLASS - For pointer operations and dereferencing
 // =============================================================================
 
-class ArduinoPointer {
+class ArduinoPointer : public RefCounted {
 private:
     EnhancedCommandValue* target_;  // What this pointer points to
     std::string targetType_;        // Type of pointed-to object
@@ -94,17 +73,84 @@ public:
 // ARDUINO ARRAY CLASS - For array indexing and multi-dimensional arrays
 // =============================================================================
 
-class ArduinoArray {
+class ArduinoArray : public RefCounted {
+public:
+    /**
+     * Element storage layout. Typed kinds pack the elements in one contiguous
+     * buffer with the target's C element size; VARIANT keeps one
+     * EnhancedCommandValue per element (structs, Strings, untyped arrays).
+     */
+    enum class ElementKind : uint8_t {
+        VARIANT,
+        BOOL,
+        CHAR,
+        INT8,
+        UINT8,
+        INT16,
+        UINT16,
+        INT32,
+        UINT32,
+        FLOAT,
+        DOUBLE
+    };
+    
+    static constexpr size_t MAX_DIMENSIONS = 8;
+    
+    /** Typed kind with the size and signedness of T */
+    template<typename T>
+    static constexpr ElementKind kindOf() {
+        if constexpr (std::is_same_v<T, bool>) return ElementKind::BOOL;
+        else if constexpr (std::is_same_v<T, char>) return ElementKind::CHAR;
+        else if constexpr (std::is_floating_point_v<T>) return sizeof(T) == sizeof(float) ? ElementKind::FLOAT : ElementKind::DOUBLE;
+        else if constexpr (sizeof(T) == 1) return std::is_signed_v<T> ? ElementKind::INT8 : ElementKind::UINT8;
+        else if constexpr (sizeof(T) == 2) return std::is_signed_v<T> ? ElementKind::INT16 : ElementKind::UINT16;
+        else return std::is_signed_v<T> ? ElementKind::INT32 : ElementKind::UINT32;
+    }
+    
+    /** Bytes per element of a typed kind (0 for VARIANT) */
+    static size_t elementSizeOf(ElementKind kind);
+    
+    /** Typed element at any byte alignment (packed struct members), boxed or C-converted */
+    static EnhancedCommandValue loadElement(ElementKind kind, const uint8_t* at);
+    static void storeElement(ElementKind kind, uint8_t* at, const EnhancedCommandValue& value);
+
 private:
-    std::vector<EnhancedCommandValue> elements_;
+    std::vector<EnhancedCommandValue> elements_;  // VARIANT storage
+    MemoryBlock bytes_;                           // Packed storage for typed kinds (simulated RAM when attached)
     std::string elementType_;
     std::vector<size_t> dimensions_;  // For multi-dimensional arrays [3][4] = {3, 4}
+    std::vector<size_t> strides_;     // Row-major element stride of each dimension [3][4] = {4, 1}
+    size_t size_;
+    ElementKind kind_;
+    uint8_t elementSize_;
+    
+    void updateShape(const std::vector<size_t>& dimensions);
+    
+    // Call fn with a null T* for the storage type of a typed kind
+    template<typename Fn>
+    static decltype(auto) withElementType(ElementKind kind, Fn&& fn) {
+        switch (kind) {
+            case ElementKind::BOOL: return fn(static_cast<bool*>(nullptr));
+            case ElementKind::CHAR: return fn(static_cast<char*>(nullptr));
+            case ElementKind::INT8: return fn(static_cast<int8_t*>(nullptr));
+            case ElementKind::UINT8: return fn(static_cast<uint8_t*>(nullptr));
+            case ElementKind::INT16: return fn(static_cast<int16_t*>(nullptr));
+            case ElementKind::UINT16: return fn(static_cast<uint16_t*>(nullptr));
+            case ElementKind::INT32: return fn(static_cast<int32_t*>(nullptr));
+            case ElementKind::UINT32: return fn(static_cast<uint32_t*>(nullptr));
+            case ElementKind::FLOAT: return fn(static_cast<float*>(nullptr));
+            default: return fn(static_cast<double*>(nullptr));
+        }
+    }
 
 public:
+    // Typed storage is a block of memory when given (std::bad_alloc when it is full)
     ArduinoArray(const std::string& elementType = "", 
-                 const std::vector<size_t>& dimensions = {});
+                 const std::vector<size_t>& dimensions = {},
+                 ElementKind kind = ElementKind::VARIANT,
+                 SimulatedMemory* memory = nullptr);
     
-    // Array access
+    // Array access (typed arrays convert on store with C truncation/wraparound)
     EnhancedCommandValue getElement(size_t index) const;
     void setElement(size_t index, const EnhancedCommandValue& value);
     
@@ -112,17 +158,57 @@ public:
     EnhancedCommandValue getElement(const std::vector<size_t>& indices) const;
     void setElement(const std::vector<size_t>& indices, const EnhancedCommandValue& value);
     
+    // Strided flat index of one subscript per dimension; throws std::out_of_range
+    size_t flatIndex(const size_t* indices, size_t count) const;
+    
     // Size operations
-    size_t size() const { return elements_.size(); }
+    size_t size() const { return size_; }
     const std::vector<size_t>& getDimensions() const { return dimensions_; }
+    size_t getStride(size_t dimensionIndex) const { return dimensionIndex < strides_.size() ? strides_[dimensionIndex] : 1; }
     
     // Type information
     const std::string& getElementType() const { return elementType_; }
+    ElementKind getElementKind() const { return kind_; }
+    bool isTyped() const { return kind_ != ElementKind::VARIANT; }
     
     // Resize operations
     void resize(size_t newSize, const EnhancedCommandValue& defaultValue = std::monostate{});
     void resizeMultiDimensional(const std::vector<size_t>& newDimensions, const EnhancedCommandValue& defaultValue = std::monostate{});
     
+    // Bulk operations (typed arrays run memset/memcpy or a vectorizable fill over the packed buffer)
+    void fill(const EnhancedCommandValue& value);
+    void fill(size_t first, size_t count, const EnhancedCommandValue& value);
+    void zero();
+    
+    // Raw bytes of typed arrays, for memset/memcpy/sizeof (empty for VARIANT)
+    size_t byteSize() const { return bytes_.size(); }
+    uint8_t* data() { return bytes_.data(); }
+    const uint8_t* data() const { return bytes_.data(); }
+    uint32_t address() const { return bytes_.address(); }  // Simulated address of element 0 (0 outside RAM)
+    size_t setBytes(size_t offset, uint8_t value, size_t count);
+    size_t copyBytes(size_t offset, const ArduinoArray& source, size_t count);
+    size_t copyBytes(size_t offset, std::string_view source);
+    
+    // C strings in byte-sized arrays (char, int8_t, uint8_t): the text up to the first NUL
+    bool isCharBuffer() const;
+    std::string_view cString(size_t offset = 0) const;
+    /** Store text and its NUL at offset, truncated to fit; returns the characters stored */
+    size_t storeCString(size_t offset, std::string_view text);
+    
+    /** Call fn(EnhancedCommandValue) for each element in storage order */
+    template<typename Fn>
+    void forEachElement(Fn&& fn) const {
+        if (kind_ == ElementKind::VARIANT) {
+            for (const auto& element : elements_) fn(element);
+            return;
+        }
+        withElementType(kind_, [&](auto* tag) {
+            using T = std::remove_pointer_t<decltype(tag)>;
+            const T* elements = reinterpret_cast<const T*>(bytes_.data());
+            for (size_t i = 0; i < size_; ++i) fn(box(elements[i]));
+        });
+    }
+    
     // Dimension operations
     size_t getDimensionCount() const { return dimensions_.size(); }
     size_t getDimensionSize(size_t dimensionIndex) const;
@@ -132,42 +218,201 @@ public:
     
     // Debug/serialization
     std::string toString() const;
+
+private:
+    /** Box a stored element the way scalars of that type evaluate */
+    template<typename T>
+    static EnhancedCommandValue box(T value) {
+        if constexpr (std::is_same_v<T, bool>) return value;
+        else if constexpr (std::is_floating_point_v<T>) return static_cast<double>(value);
+        else if constexpr (std::is_same_v<T, uint32_t>) {
+            if (value > static_cast<uint32_t>(INT32_MAX)) return static_cast<double>(value);
+            return static_cast<int32_t>(value);
+        } else return static_cast<int32_t>(value);
+    }
 };
 
 // =============================================================================
-// ARDUINO STRING CLASS - Enhanced string operations matching JavaScript
+// ARDUINO STRUCT CLASS - Packed fixed-offset records for struct members
 // =============================================================================
 
-class ArduinoString {
+/**
+ * Member layout of one struct type, computed once per declaration. Numeric
+ * members are packed at fixed byte offsets with the target's C sizes and
+ * alignment; Strings, arrays and nested structs live in object slots.
+ */
+struct StructLayout : RefCounted {
+    struct Field {
+        std::string name;
+        std::string typeName;
+        ArduinoArray::ElementKind kind = ArduinoArray::ElementKind::VARIANT;  // VARIANT: object slot
+        uint32_t offset = 0;           // Byte offset of packed members, slot index otherwise
+        EnhancedCommandValue initial;  // Initial value of slot members (nested struct, array, String)
+        
+        bool isPacked() const { return kind != ArduinoArray::ElementKind::VARIANT; }
+    };
+    
+    std::string typeName;
+    std::vector<Field> fields;
+    uint32_t byteSize = 0;
+    uint32_t alignment = 1;
+    uint32_t objectSlots = 0;
+    bool open = false;  // Ad-hoc object: setMember adds undeclared members
+    
+    explicit StructLayout(const std::string& name = "struct") : typeName(name) {}
+    
+    /** Append a member; packed members align to min(size, maxAlignment) */
+    void addField(const std::string& name, const std::string& type, ArduinoArray::ElementKind kind,
+                  const EnhancedCommandValue& initial = std::monostate{}, uint32_t maxAlignment = 8);
+    
+    /** Pad byteSize to the struct alignment once all members are added */
+    void finish();
+    
+    /** Member index by name, -1 if absent */
+    int32_t fieldIndex(const std::string& name) const;
+};
+
+/**
+ * Struct instance with value semantics. Copies share one record until either
+ * side writes, which then copies the packed bytes (and clones nested objects)
+ * before changing them.
+ */
+class ArduinoStruct : public RefCounted {
 private:
-    std::string data_;
+    struct Storage : RefCounted {
+        std::vector<uint8_t> bytes;                 // Packed members
+        std::vector<EnhancedCommandValue> objects;  // Slot members
+    };
     
+    Ref<const StructLayout> layout_;
+    Ref<Storage> storage_;
+    
+    /** Give this instance its own record before a write */
+    void detach();
+
 public:
-    explicit ArduinoString(const std::string& str = "");
+    explicit ArduinoStruct(const std::string& typeName = "struct");
+    explicit ArduinoStruct(Ref<const StructLayout> layout);
+    
+    // Copy-on-write: copying shares the record
+    ArduinoStruct(const ArduinoStruct&) = default;
+    ArduinoStruct& operator=(const ArduinoStruct&) = default;
+    
+    // Member access by name
+    bool hasMember(const std::string& name) const;
+    EnhancedCommandValue getMember(const std::string& name) const;
+    void setMember(const std::string& name, const EnhancedCommandValue& value);
+    
+    // Member access by layout index; packed stores convert with C semantics (throw std::invalid_argument)
+    EnhancedCommandValue getField(size_t index) const;
+    void setField(size_t index, const EnhancedCommandValue& value);
+    
+    // Nested struct member, or nullptr; the mutable form detaches this record first
+    const ArduinoStruct* structField(size_t index) const;
+    ArduinoStruct* mutableStructField(size_t index);
+    
+    // Layout and type information
+    const StructLayout& layout() const { return *layout_; }
+    const Ref<const StructLayout>& getLayout() const { return layout_; }
+    const std::string& getTypeName() const { return layout_->typeName; }
+    
+    // Packed record bytes
+    size_t byteSize() const { return storage_->bytes.size(); }
+    const uint8_t* data() const { return storage_->bytes.data(); }
+    bool sharesRecordWith(const ArduinoStruct& other) const { return storage_ == other.storage_; }
+    
+    // Debug/serialization
+    std::string toString() const;
+};
+
+// =============================================================================
+// ARDUINO STRING CLASS - Arduino String semantics on a reusable buffer
+// =============================================================================
+
+class ArduinoString;
+
+/**
+ * The read-only operations of Arduino's String class on a string it does not
+ * own, so querying a shared (interned or copied-on-write) buffer leaves it
+ * shared.
+ */
+class ArduinoStringView {
+private:
+    const std::string& data_;
+    
+public:
+    explicit ArduinoStringView(const std::string& data) noexcept : data_(data) {}
     
-    // String operations matching Arduino String class
     size_t length() const { return data_.length(); }
     char charAt(size_t index) const;
-    void setCharAt(size_t index, char c);
-    
-    // Arduino String methods
     ArduinoString substring(size_t start, size_t end = std::string::npos) const;
     int indexOf(const std::string& str, size_t start = 0) const;
     int lastIndexOf(const std::string& str, size_t start = std::string::npos) const;
     bool startsWith(const std::string& str) const;
     bool endsWith(const std::string& str) const;
-    
-    // Case operations
-    ArduinoString toLowerCase() const;
-    ArduinoString toUpperCase() const;
-    
-    // Numeric conversions
+    bool equals(const std::string& str) const { return data_ == str; }
+    bool equalsIgnoreCase(const std::string& str) const;
+    int compareTo(const std::string& str) const;
     int toInt() const;
     double toFloat() const;
+    const std::string& c_str() const { return data_; }
+};
+
+/**
+ * Mutable string with the semantics of Arduino's String class: concat() and
+ * += append in place and keep their capacity, reserve() only ever grows the
+ * buffer, and the case, trim, replace and remove operations modify the
+ * string instead of returning a copy. Short contents stay in the inline
+ * buffer of std::string (15 chars with libstdc++), so they never allocate.
+ *
+ * An ArduinoString can adopt an existing buffer and hand it back (release()),
+ * which lets the interpreter run these operations on a String variable's own
+ * storage without copying it.
+ */
+class ArduinoString : public RefCounted {
+private:
+    std::string data_;
+    
+public:
+    ArduinoString() = default;
+    explicit ArduinoString(const std::string& str);
+    explicit ArduinoString(std::string&& buffer) noexcept : data_(std::move(buffer)) {}
     
-    // String modification
-    ArduinoString trim() const;
-    ArduinoString replace(const std::string& find, const std::string& replace) const;
+    // Length and buffer management
+    size_t length() const { return data_.length(); }
+    size_t capacity() const { return data_.capacity(); }
+    bool reserve(size_t size);
+    
+    // Appending (in place)
+    bool concat(const std::string& text);
+    bool concat(char c);
+    
+    // Character access
+    char charAt(size_t index) const { return view().charAt(index); }
+    void setCharAt(size_t index, char c);
+    
+    // Searching and comparison
+    ArduinoString substring(size_t start, size_t end = std::string::npos) const;
+    int indexOf(const std::string& str, size_t start = 0) const { return view().indexOf(str, start); }
+    int lastIndexOf(const std::string& str, size_t start = std::string::npos) const {
+        return view().lastIndexOf(str, start);
+    }
+    bool startsWith(const std::string& str) const { return view().startsWith(str); }
+    bool endsWith(const std::string& str) const { return view().endsWith(str); }
+    bool equals(const std::string& str) const { return data_ == str; }
+    bool equalsIgnoreCase(const std::string& str) const { return view().equalsIgnoreCase(str); }
+    int compareTo(const std::string& str) const { return view().compareTo(str); }
+    
+    // In-place modification
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    void replace(const std::string& find, const std::string& replacement);
+    void remove(size_t index, size_t count = std::string::npos);
+    
+    // Numeric conversions
+    int toInt() const { return view().toInt(); }
+    double toFloat() const { return view().toFloat(); }
     
     // Operators
     ArduinoString operator+(const ArduinoString& other) const;
@@ -182,11 +427,45 @@ public:
     
     // Access to underlying string
     const std::string& c_str() const { return data_; }
+    ArduinoStringView view() const noexcept { return ArduinoStringView(data_); }
+    std::string release() noexcept { return std::move(data_); }
     
     // Debug/serialization
     std::string toString() const { return data_; }
 };
 
+/**
+ * Pending String concatenation, the role of Arduino's StringSumHelper: the
+ * pieces of `"T=" + String(t) + " C" + ...` are collected as views and copied
+ * once into a buffer of the final length when the result is consumed, instead
+ * of building a new string at every `+`. The caller keeps the viewed values
+ * alive until flatten().
+ */
+class StringRope {
+public:
+    static constexpr size_t MAX_PIECES = 16;
+    
+    /** Add a piece; returns false (and adds nothing) when the rope is full */
+    bool append(std::string_view piece) {
+        if (count_ == MAX_PIECES) return false;
+        pieces_[count_++] = piece;
+        length_ += piece.size();
+        return true;
+    }
+    
+    size_t pieceCount() const { return count_; }
+    size_t length() const { return length_; }
+    
+    /** Append all pieces to out with a single reservation */
+    void flattenInto(std::string& out) const;
+    std::string flatten() const;
+    
+private:
+    std::string_view pieces_[MAX_PIECES];
+    size_t count_ = 0;
+    size_t length_ = 0;
+};
+
 // =============================================================================
 // UTILITY FUNCTIONS FOR TYPE CONVERSION AND INTEGRATION
 // =============================================================================
@@ -205,8 +484,11 @@ bool isStringType(const EnhancedCommandValue& value);
 std::string enhancedCommandValueToString(const EnhancedCommandValue& value);
 
 // Factory functions for creating complex types
-std::shared_ptr<ArduinoStruct> createStruct(const std::string& typeName = "struct");
-std::shared_ptr<ArduinoArray> createArray(const std::string& elementType, const std::vector<size_t>& dimensions);
-std::shared_ptr<ArduinoString> createString(const std::string& initialValue = "");
+Ref<ArduinoStruct> createStruct(const std::string& typeName = "struct");
+Ref<ArduinoStruct> createStruct(Ref<const StructLayout> layout);
+Ref<ArduinoArray> createArray(const std::string& elementType, const std::vector<size_t>& dimensions,
+                                          ArduinoArray::ElementKind kind = ArduinoArray::ElementKind::VARIANT,
+                                          SimulatedMemory* memory = nullptr);
+Ref<ArduinoString> createString(const std::string& initialValue = "");
 
 } // namespace arduino_interpreter
\ No newline at end of file
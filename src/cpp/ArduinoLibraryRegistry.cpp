@@ -20,7 +20,7 @@ static int32_t convertToInt(const CommandValue& value) {
     if (std::holds_alternative<int>(value)) {
         return std::get<int>(value);
     } else if (std::holds_alternative<double>(value)) {
-        return static_cast<int32_t>(std::get<double>(value));
+        return target::wrapToInt32(std::get<double>(value));
     } else if (std::holds_alternative<bool>(value)) {
         return std::get<bool>(value) ? 1 : 0;
     }
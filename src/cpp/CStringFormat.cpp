@@ -0,0 +1,356 @@
+/**
+ * CStringFormat.cpp - Formatting for the C string builtins
+ *
+ * Version: 1.0
+ */
+
+#include "CStringFormat.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace arduino_interpreter {
+
+namespace {
+
+const uint64_t POWERS_OF_TEN[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+};
+constexpr int MAX_INTEGER_PRECISION = 9;
+constexpr double MAX_SCALED = 9.0e18;   // Below 2^63 with room for rounding
+
+/** Digits of value ending at end; returns the first digit */
+char* formatUnsigned(char* end, uint64_t value, unsigned base, bool uppercase) {
+    const char* digits = uppercase ? "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" : "0123456789abcdefghijklmnopqrstuvwxyz";
+    char* start = end;
+    do {
+        *--start = digits[value % base];
+        value /= base;
+    } while (value != 0);
+    return start;
+}
+
+/** Fixed-point digits of a finite, non-negative value */
+void appendMagnitude(std::string& out, double magnitude, int precision) {
+    if (precision <= MAX_INTEGER_PRECISION && magnitude * POWERS_OF_TEN[precision] < MAX_SCALED) {
+        uint64_t scale = POWERS_OF_TEN[precision];
+        uint64_t units = static_cast<uint64_t>(std::round(magnitude * static_cast<double>(scale)));
+        appendUnsigned(out, units / scale);
+        if (precision > 0) {
+            char fraction[MAX_INTEGER_PRECISION];
+            char* end = fraction + precision;
+            char* start = formatUnsigned(end, units % scale, 10, false);
+            out += '.';
+            out.append(static_cast<size_t>(start - fraction), '0');
+            out.append(start, end);
+        }
+        return;
+    }
+
+    // Huge values or long fractions: exact digits from the C library
+    char buffer[512];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.*f", precision, magnitude);
+    if (length >= static_cast<int>(sizeof(buffer))) {
+        std::string wide(static_cast<size_t>(length) + 1, '\0');
+        std::snprintf(&wide[0], wide.size(), "%.*f", precision, magnitude);
+        out.append(wide.data(), static_cast<size_t>(length));
+    } else if (length > 0) {
+        out.append(buffer, static_cast<size_t>(length));
+    }
+}
+
+struct ConversionSpec {
+    bool left = false;
+    bool plus = false;
+    bool space = false;
+    bool zero = false;
+    bool alternate = false;
+    size_t width = 0;
+    int precision = -1;     // -1 when not given
+    int longs = 0;          // Number of 'l' modifiers
+    bool shortInt = false;  // 'h' or 'hh'
+};
+
+void appendPadded(std::string& out, const ConversionSpec& spec, std::string_view prefix,
+                  std::string_view body, bool zeroPad) {
+    size_t length = prefix.size() + body.size();
+    size_t fill = spec.width > length ? spec.width - length : 0;
+    if (spec.left) {
+        out += prefix;
+        out += body;
+        out.append(fill, ' ');
+    } else if (zeroPad) {
+        out += prefix;
+        out.append(fill, '0');
+        out += body;
+    } else {
+        out.append(fill, ' ');
+        out += prefix;
+        out += body;
+    }
+}
+
+int64_t integerArgument(const CommandValue* args, size_t count, size_t index) {
+    if (index >= count) return 0;
+    const CommandValue& arg = args[index];
+    if (const auto* value = std::get_if<int32_t>(&arg)) return *value;
+    if (const auto* value = std::get_if<bool>(&arg)) return *value ? 1 : 0;
+    if (const auto* value = std::get_if<double>(&arg)) {
+        return std::isfinite(*value) && std::fabs(*value) < MAX_SCALED ? static_cast<int64_t>(*value) : 0;
+    }
+    return 0;
+}
+
+double floatArgument(const CommandValue* args, size_t count, size_t index) {
+    if (index >= count) return 0.0;
+    const CommandValue& arg = args[index];
+    if (const auto* value = std::get_if<double>(&arg)) return *value;
+    if (const auto* value = std::get_if<int32_t>(&arg)) return *value;
+    if (const auto* value = std::get_if<bool>(&arg)) return *value ? 1.0 : 0.0;
+    return 0.0;
+}
+
+std::string_view textArgument(const CommandValue* args, size_t count, size_t index, std::string& scratch) {
+    if (index >= count) return {};
+    if (const auto* text = std::get_if<std::string>(&args[index])) return *text;
+    if (std::holds_alternative<std::monostate>(args[index])) return {};
+    scratch = commandValueToString(args[index]);
+    return scratch;
+}
+
+/** Reduce an integer argument to the C type the conversion reads */
+int64_t signedForWidth(int64_t value, const ConversionSpec& spec, const PrintfTarget& target) {
+    if (spec.longs >= 2) return value;
+    if (spec.shortInt || (spec.longs == 0 && target.intBits == 16)) return static_cast<int16_t>(value);
+    return static_cast<int32_t>(value);
+}
+
+uint64_t unsignedForWidth(int64_t value, const ConversionSpec& spec, const PrintfTarget& target) {
+    if (spec.longs >= 2) return static_cast<uint64_t>(value);
+    if (spec.shortInt || (spec.longs == 0 && target.intBits == 16)) return static_cast<uint16_t>(value);
+    return static_cast<uint32_t>(value);
+}
+
+void appendIntegerConversion(std::string& out, const ConversionSpec& spec, char conversion,
+                             int64_t argument, const PrintfTarget& target) {
+    char digits[72];
+    char* end = digits + sizeof(digits);
+    char sign[3] = {0, 0, 0};
+    uint64_t magnitude = 0;
+    unsigned base = 10;
+
+    if (conversion == 'd' || conversion == 'i') {
+        int64_t value = signedForWidth(argument, spec, target);
+        magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        if (value < 0) sign[0] = '-';
+        else if (spec.plus) sign[0] = '+';
+        else if (spec.space) sign[0] = ' ';
+    } else {
+        magnitude = unsignedForWidth(argument, spec, target);
+        base = conversion == 'o' ? 8 : (conversion == 'u' ? 10 : 16);
+        if (spec.alternate && magnitude != 0 && base == 16) {
+            sign[0] = '0';
+            sign[1] = conversion;
+        }
+    }
+
+    char* start = end;
+    if (magnitude != 0 || spec.precision != 0) {
+        start = formatUnsigned(end, magnitude, base, conversion == 'X');
+    }
+    while (spec.precision > 0 && end - start < spec.precision && start > digits) {
+        *--start = '0';
+    }
+    if (spec.alternate && base == 8 && (start == end || *start != '0')) {
+        *--start = '0';
+    }
+    appendPadded(out, spec, sign, std::string_view(start, static_cast<size_t>(end - start)),
+                 spec.zero && spec.precision < 0);
+}
+
+void appendFloatConversion(std::string& out, const ConversionSpec& spec, char conversion, double value) {
+    int precision = spec.precision < 0 ? 6 : spec.precision;
+    const char* sign = std::signbit(value) ? "-" : (spec.plus ? "+" : (spec.space ? " " : ""));
+    std::string body;
+
+    if (!std::isfinite(value)) {
+        bool upper = conversion == 'F' || conversion == 'E' || conversion == 'G';
+        body = std::isnan(value) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+        appendPadded(out, spec, sign, body, false);
+        return;
+    }
+
+    if (conversion == 'f' || conversion == 'F') {
+        appendMagnitude(body, std::fabs(value), precision);
+    } else {
+        char format[6];
+        size_t at = 0;
+        format[at++] = '%';
+        if (spec.alternate) format[at++] = '#';
+        format[at++] = '.';
+        format[at++] = '*';
+        format[at++] = conversion;
+        format[at] = 0;
+        char buffer[64];
+        int length = std::snprintf(buffer, sizeof(buffer), format, std::min(precision, 40), std::fabs(value));
+        if (length > 0) {
+            body.assign(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+        }
+    }
+    appendPadded(out, spec, sign, body, spec.zero);
+}
+
+} // anonymous namespace
+
+void appendUnsigned(std::string& out, uint64_t value, unsigned base, bool uppercase) {
+    if (base < 2 || base > 36) base = 10;
+    char digits[64];
+    char* end = digits + sizeof(digits);
+    out.append(formatUnsigned(end, value, base, uppercase), end);
+}
+
+void appendFixed(std::string& out, double value, int precision) {
+    if (precision < 0) precision = 0;
+    if (std::isnan(value)) {
+        out += "nan";
+        return;
+    }
+    if (std::signbit(value)) {
+        out += '-';
+    }
+    if (std::isinf(value)) {
+        out += "inf";
+        return;
+    }
+    appendMagnitude(out, std::fabs(value), precision);
+}
+
+void appendDtostrf(std::string& out, double value, int width, int precision) {
+    size_t start = out.size();
+    appendFixed(out, value, precision);
+    size_t length = out.size() - start;
+    size_t target = static_cast<size_t>(width < 0 ? -static_cast<int64_t>(width) : width);
+    if (length >= target) return;
+    if (width < 0) {
+        out.append(target - length, ' ');
+    } else {
+        out.insert(start, target - length, ' ');
+    }
+}
+
+size_t appendPrintf(std::string& out, std::string_view format, const CommandValue* args, size_t argCount,
+                    const PrintfTarget& target) {
+    size_t start = out.size();
+    size_t next = 0;
+    std::string scratch;
+
+    for (size_t i = 0; i < format.size();) {
+        if (format[i] != '%') {
+            size_t run = format.find('%', i);
+            if (run == std::string_view::npos) run = format.size();
+            out.append(format.data() + i, run - i);
+            i = run;
+            continue;
+        }
+
+        size_t specStart = i++;
+        if (i < format.size() && format[i] == '%') {
+            out += '%';
+            ++i;
+            continue;
+        }
+
+        ConversionSpec spec;
+        for (; i < format.size(); ++i) {
+            char flag = format[i];
+            if (flag == '-') spec.left = true;
+            else if (flag == '+') spec.plus = true;
+            else if (flag == ' ') spec.space = true;
+            else if (flag == '0') spec.zero = true;
+            else if (flag == '#') spec.alternate = true;
+            else break;
+        }
+        if (i < format.size() && format[i] == '*') {
+            int64_t width = integerArgument(args, argCount, next++);
+            spec.left = spec.left || width < 0;
+            spec.width = static_cast<size_t>(width < 0 ? -width : width);
+            ++i;
+        } else {
+            for (; i < format.size() && format[i] >= '0' && format[i] <= '9'; ++i) {
+                spec.width = spec.width * 10 + static_cast<size_t>(format[i] - '0');
+            }
+        }
+        if (i < format.size() && format[i] == '.') {
+            ++i;
+            spec.precision = 0;
+            if (i < format.size() && format[i] == '*') {
+                int64_t precision = integerArgument(args, argCount, next++);
+                spec.precision = precision < 0 ? -1 : static_cast<int>(precision);
+                ++i;
+            } else {
+                for (; i < format.size() && format[i] >= '0' && format[i] <= '9'; ++i) {
+                    spec.precision = spec.precision * 10 + (format[i] - '0');
+                }
+            }
+        }
+        for (; i < format.size(); ++i) {
+            char length = format[i];
+            if (length == 'l') ++spec.longs;
+            else if (length == 'h') spec.shortInt = true;
+            else if (length == 'j' || length == 'z' || length == 't' || length == 'q') spec.longs = 2;
+            else if (length != 'L') break;
+        }
+        if (i >= format.size()) {
+            out.append(format.data() + specStart, format.size() - specStart);
+            break;
+        }
+
+        char conversion = format[i++];
+        switch (conversion) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+                appendIntegerConversion(out, spec, conversion, integerArgument(args, argCount, next++), target);
+                break;
+
+            case 'c': {
+                char character = 0;
+                if (next < argCount) {
+                    if (const auto* text = std::get_if<std::string>(&args[next])) {
+                        character = text->empty() ? 0 : (*text)[0];
+                    } else {
+                        character = static_cast<char>(integerArgument(args, argCount, next));
+                    }
+                }
+                ++next;
+                appendPadded(out, spec, {}, std::string_view(&character, 1), false);
+                break;
+            }
+
+            case 's': {
+                std::string_view text = textArgument(args, argCount, next++, scratch);
+                if (spec.precision >= 0 && text.size() > static_cast<size_t>(spec.precision)) {
+                    text = text.substr(0, static_cast<size_t>(spec.precision));
+                }
+                appendPadded(out, spec, {}, text, false);
+                break;
+            }
+
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                if (!target.floatConversions) {
+                    ++next;
+                    appendPadded(out, spec, {}, "?", false);
+                } else {
+                    appendFloatConversion(out, spec, conversion, floatArgument(args, argCount, next++));
+                }
+                break;
+
+            default:
+                // Unsupported conversion (%p, %n, ...): copied through unchanged
+                out.append(format.data() + specStart, i - specStart);
+                break;
+        }
+    }
+
+    return out.size() - start;
+}
+
+} // namespace arduino_interpreter
@@ -0,0 +1,45 @@
+/**
+ * CStringFormat.hpp - Formatting for the C string builtins
+ *
+ * sprintf/snprintf, dtostrf and itoa run on every loop() of a typical sensor
+ * sketch. These formatters append straight to a std::string using hand-written
+ * integer and fixed-point conversion: no iostreams, no locale, and nothing
+ * allocated beyond the growth of the output. Exponent forms (%e, %g) are rare
+ * in sketches and go through the C library.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include "CommandProtocol.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace arduino_interpreter {
+
+/** Target differences in the printf family */
+struct PrintfTarget {
+    uint8_t intBits = 32;           // Width of %d/%u/%x without 'l' (16 on AVR)
+    bool floatConversions = true;   // avr-libc's default printf prints '?' for %f/%e/%g
+};
+
+/** Append value in base 2..36 with lowercase or uppercase digits */
+void appendUnsigned(std::string& out, uint64_t value, unsigned base = 10, bool uppercase = false);
+
+/** Append value with exactly precision fraction digits (%.Nf) */
+void appendFixed(std::string& out, double value, int precision);
+
+/** dtostrf(): value right-aligned in width characters (left-aligned when width is negative) */
+void appendDtostrf(std::string& out, double value, int width, int precision);
+
+/**
+ * Append format with its conversions applied to args (printf semantics:
+ * flags, width, precision, '*', length modifiers). Missing arguments format
+ * as zero or empty text. Returns the number of characters appended.
+ */
+size_t appendPrintf(std::string& out, std::string_view format, const CommandValue* args, size_t argCount,
+                    const PrintfTarget& target = PrintfTarget{});
+
+} // namespace arduino_interpreter
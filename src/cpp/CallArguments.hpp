@@ -0,0 +1,152 @@
+/**
+ * CallArguments.hpp - Argument lists of builtin and user function calls
+ *
+ * Every call in a sketch evaluates its arguments into a list that lives only
+ * until the call returns. CallArguments keeps up to INLINE_CAPACITY values
+ * on the caller's stack, which covers every Arduino builtin; longer lists
+ * spill into the TickArena instead of the host heap.
+ *
+ * TickArena is a bump allocator for such transient storage. Its chunks are
+ * kept when it is reset, at the end of each loop() pass and tick(), so a
+ * sketch in its steady state allocates nothing for its calls. Objects placed
+ * in the arena are destroyed by their owner; the arena only recycles bytes.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include "CommandProtocol.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace arduino_interpreter {
+
+class TickArena {
+public:
+    static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+    TickArena() = default;
+    TickArena(const TickArena&) = delete;
+    TickArena& operator=(const TickArena&) = delete;
+
+    /** size bytes aligned to alignment, valid until the next reset() */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        while (chunk_ < chunks_.size()) {
+            Chunk& chunk = chunks_[chunk_];
+            size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+            if (start + size <= chunk.size) {
+                offset_ = start + size;
+                return chunk.bytes.get() + start;
+            }
+            chunk_++;
+            offset_ = 0;
+        }
+        size_t chunkSize = std::max(CHUNK_SIZE, size + alignment);
+        chunks_.push_back(Chunk{std::unique_ptr<uint8_t[]>(new uint8_t[chunkSize]), chunkSize});
+        offset_ = 0;
+        return allocate(size, alignment);
+    }
+
+    /** Recycle every allocation; the chunks stay for the next tick */
+    void reset() {
+        chunk_ = 0;
+        offset_ = 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const auto& chunk : chunks_) total += chunk.size;
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<uint8_t[]> bytes;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks_;
+    size_t chunk_ = 0;       // Chunk being filled
+    size_t offset_ = 0;      // First free byte in it
+};
+
+/**
+ * Evaluated arguments of one call: inline up to INLINE_CAPACITY values,
+ * in the arena beyond that (on the host heap when there is no arena).
+ */
+class CallArguments {
+public:
+    static constexpr size_t INLINE_CAPACITY = 6;
+
+    explicit CallArguments(TickArena* arena = nullptr) : arena_(arena) {}
+
+    CallArguments(const CallArguments&) = delete;
+    CallArguments& operator=(const CallArguments&) = delete;
+
+    ~CallArguments() {
+        clear();
+        if (data_ != inlineData() && !arena_) {
+            ::operator delete(data_);
+        }
+    }
+
+    void push_back(CommandValue value) {
+        if (size_ == capacity_) {
+            grow();
+        }
+        new (data_ + size_) CommandValue(std::move(value));
+        size_++;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < size_; ++i) {
+            data_[i].~CommandValue();
+        }
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    CommandValue& operator[](size_t index) { return data_[index]; }
+    const CommandValue& operator[](size_t index) const { return data_[index]; }
+
+    const CommandValue* begin() const { return data_; }
+    const CommandValue* end() const { return data_ + size_; }
+
+    /** Copy for interfaces that keep the list (library callbacks, result caches) */
+    std::vector<CommandValue> toVector() const { return std::vector<CommandValue>(begin(), end()); }
+
+private:
+    CommandValue* inlineData() { return reinterpret_cast<CommandValue*>(inline_); }
+
+    void grow() {
+        size_t capacity = capacity_ * 2;
+        void* bytes = arena_ ? arena_->allocate(capacity * sizeof(CommandValue), alignof(CommandValue))
+                             : ::operator new(capacity * sizeof(CommandValue));
+        auto* grown = static_cast<CommandValue*>(bytes);
+        for (size_t i = 0; i < size_; ++i) {
+            new (grown + i) CommandValue(std::move(data_[i]));
+            data_[i].~CommandValue();
+        }
+        if (data_ != inlineData() && !arena_) {
+            ::operator delete(data_);
+        }
+        data_ = grown;
+        capacity_ = capacity;
+    }
+
+    alignas(CommandValue) unsigned char inline_[INLINE_CAPACITY * sizeof(CommandValue)];
+    CommandValue* data_ = inlineData();
+    size_t size_ = 0;
+    size_t capacity_ = INLINE_CAPACITY;
+    TickArena* arena_;
+};
+
+} // namespace arduino_interpreter
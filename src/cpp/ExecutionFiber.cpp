@@ -0,0 +1,321 @@
+/**
+ * ExecutionFiber.cpp - Stack switching for suspendable interpreter execution
+ */
+
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600  // ucontext is only exposed in XSI mode on macOS
+#endif
+
+#include "ExecutionFiber.hpp"
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(ESP_PLATFORM) && !defined(EXECUTION_FIBER_USE_THREADS)
+#define EXECUTION_FIBER_UCONTEXT 1
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#else
+#define EXECUTION_FIBER_UCONTEXT 0
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace arduino_interpreter {
+
+#if EXECUTION_FIBER_UCONTEXT
+
+// =============================================================================
+// UCONTEXT BACKEND
+// =============================================================================
+
+struct ExecutionFiber::Context {
+    ucontext_t caller;
+    ucontext_t fiber;
+    void* mapping = MAP_FAILED;
+    size_t mappingSize = 0;
+    uintptr_t stackLow = 0;  // Lowest usable address, just above the guard page
+
+    /**
+     * makecontext only passes int arguments, so the fiber pointer is split in two
+     */
+    static void entry(unsigned int high, unsigned int low) {
+        uint64_t bits = (static_cast<uint64_t>(high) << 32) | low;
+        reinterpret_cast<ExecutionFiber*>(static_cast<uintptr_t>(bits))->run();
+    }
+};
+
+ExecutionFiber::ExecutionFiber(std::function<void()> entry, size_t stackSize)
+    : entry_(std::move(entry)), stackSize_(stackSize), context_(std::make_unique<Context>()) {
+
+    // Guard page below the stack turns an overflow into a fault instead of silent corruption
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t usable = ((stackSize_ + pageSize - 1) / pageSize) * pageSize;
+    context_->mappingSize = usable + pageSize;
+    context_->mapping = mmap(nullptr, context_->mappingSize, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (context_->mapping == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    mprotect(context_->mapping, pageSize, PROT_NONE);
+
+    if (getcontext(&context_->fiber) != 0) {
+        munmap(context_->mapping, context_->mappingSize);
+        throw std::runtime_error("ExecutionFiber: getcontext failed");
+    }
+    context_->stackLow = reinterpret_cast<uintptr_t>(context_->mapping) + pageSize;
+    context_->fiber.uc_stack.ss_sp = reinterpret_cast<void*>(context_->stackLow);
+    context_->fiber.uc_stack.ss_size = usable;
+    context_->fiber.uc_link = &context_->caller;
+
+    uint64_t bits = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(this));
+    makecontext(&context_->fiber, reinterpret_cast<void (*)()>(&Context::entry), 2,
+                static_cast<unsigned int>(bits >> 32), static_cast<unsigned int>(bits & 0xFFFFFFFFu));
+}
+
+ExecutionFiber::~ExecutionFiber() {
+    if (started_ && !finished_ && !running_) {
+        cancelRequested_ = true;
+        try {
+            resume();
+        } catch (...) {
+            // Unwinding a cancelled fiber must not escape the destructor
+        }
+    }
+    if (context_->mapping != MAP_FAILED) {
+        munmap(context_->mapping, context_->mappingSize);
+    }
+}
+
+void ExecutionFiber::resume() {
+    if (finished_) {
+        return;
+    }
+    if (running_) {
+        throw std::logic_error("ExecutionFiber::resume called from inside the fiber");
+    }
+
+    started_ = true;
+    running_ = true;
+    swapcontext(&context_->caller, &context_->fiber);
+    running_ = false;
+
+    if (exception_) {
+        std::exception_ptr pending = exception_;
+        exception_ = nullptr;
+        std::rethrow_exception(pending);
+    }
+}
+
+void ExecutionFiber::yield() {
+    if (!running_) {
+        throw std::logic_error("ExecutionFiber::yield called outside the fiber");
+    }
+    swapcontext(&context_->fiber, &context_->caller);
+
+    if (cancelRequested_) {
+        throw Cancelled{};
+    }
+}
+
+size_t ExecutionFiber::stackRoom(const void* address) const {
+    uintptr_t here = reinterpret_cast<uintptr_t>(address);
+    return here > context_->stackLow ? here - context_->stackLow : 0;
+}
+
+#else
+
+// =============================================================================
+// THREAD HAND-OFF BACKEND
+// =============================================================================
+
+/**
+ * The fiber thread is created natively: std::thread cannot be given a stack
+ * size, and the default (8 MB on Linux, 1 MB on Windows, a few KB on ESP-IDF)
+ * has nothing to do with the size the interpreter asked for
+ */
+struct ExecutionFiber::Context {
+#if defined(_WIN32)
+    HANDLE thread = nullptr;
+#else
+    pthread_t thread{};
+    bool threadCreated = false;
+#endif
+    std::mutex mutex;
+    std::condition_variable turnChanged;
+    bool fiberTurn = false;
+
+    static void body(ExecutionFiber* fiber) {
+        Context& context = *fiber->context_;
+        {
+            std::unique_lock<std::mutex> lock(context.mutex);
+            context.turnChanged.wait(lock, [&context]() { return context.fiberTurn; });
+        }
+        fiber->run();
+        std::lock_guard<std::mutex> lock(context.mutex);
+        context.fiberTurn = false;
+        context.turnChanged.notify_all();
+    }
+
+#if defined(_WIN32)
+    static DWORD WINAPI threadEntry(LPVOID fiber) {
+        body(static_cast<ExecutionFiber*>(fiber));
+        return 0;
+    }
+
+    void start(ExecutionFiber* fiber, size_t stackSize) {
+        thread = CreateThread(nullptr, stackSize, &threadEntry, fiber, STACK_SIZE_PARAM_IS_A_RESERVATION, nullptr);
+        if (!thread) {
+            throw std::runtime_error("ExecutionFiber: CreateThread failed");
+        }
+    }
+
+    void join() {
+        if (thread) {
+            WaitForSingleObject(thread, INFINITE);
+            CloseHandle(thread);
+            thread = nullptr;
+        }
+    }
+#else
+    static void* threadEntry(void* fiber) {
+        body(static_cast<ExecutionFiber*>(fiber));
+        return nullptr;
+    }
+
+    void start(ExecutionFiber* fiber, size_t stackSize) {
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        pthread_attr_setstacksize(&attributes, stackSize);
+        int error = pthread_create(&thread, &attributes, &threadEntry, fiber);
+        pthread_attr_destroy(&attributes);
+        if (error != 0) {
+            throw std::runtime_error("ExecutionFiber: pthread_create failed");
+        }
+        threadCreated = true;
+    }
+
+    void join() {
+        if (threadCreated) {
+            pthread_join(thread, nullptr);
+            threadCreated = false;
+        }
+    }
+#endif
+};
+
+ExecutionFiber::ExecutionFiber(std::function<void()> entry, size_t stackSize)
+    : entry_(std::move(entry)), stackSize_(stackSize), context_(std::make_unique<Context>()) {
+}
+
+ExecutionFiber::~ExecutionFiber() {
+    if (started_ && !finished_ && !running_) {
+        cancelRequested_ = true;
+        try {
+            resume();
+        } catch (...) {
+            // Unwinding a cancelled fiber must not escape the destructor
+        }
+    }
+    context_->join();
+}
+
+void ExecutionFiber::resume() {
+    if (finished_) {
+        return;
+    }
+    if (running_) {
+        throw std::logic_error("ExecutionFiber::resume called from inside the fiber");
+    }
+
+    if (!started_) {
+        context_->start(this, stackSize_);
+        started_ = true;
+    }
+
+    running_ = true;
+    {
+        std::unique_lock<std::mutex> lock(context_->mutex);
+        context_->fiberTurn = true;
+        context_->turnChanged.notify_all();
+        context_->turnChanged.wait(lock, [this]() { return !context_->fiberTurn; });
+    }
+    running_ = false;
+
+    if (exception_) {
+        std::exception_ptr pending = exception_;
+        exception_ = nullptr;
+        std::rethrow_exception(pending);
+    }
+}
+
+void ExecutionFiber::yield() {
+    if (!running_) {
+        throw std::logic_error("ExecutionFiber::yield called outside the fiber");
+    }
+    {
+        std::unique_lock<std::mutex> lock(context_->mutex);
+        context_->fiberTurn = false;
+        context_->turnChanged.notify_all();
+        context_->turnChanged.wait(lock, [this]() { return context_->fiberTurn; });
+    }
+
+    if (cancelRequested_) {
+        throw Cancelled{};
+    }
+}
+
+size_t ExecutionFiber::stackRoom(const void* address) const {
+    // The fiber is a thread of its own
+    return threadStackRoom(address);
+}
+
+#endif
+
+// =============================================================================
+// COMMON
+// =============================================================================
+
+size_t ExecutionFiber::threadStackRoom(const void* address) {
+    uintptr_t here = reinterpret_cast<uintptr_t>(address);
+    uintptr_t low = 0;
+#if defined(_WIN32)
+    ULONG_PTR lowLimit = 0;
+    ULONG_PTR highLimit = 0;
+    GetCurrentThreadStackLimits(&lowLimit, &highLimit);
+    low = static_cast<uintptr_t>(lowLimit);
+#elif defined(__APPLE__)
+    pthread_t self = pthread_self();
+    low = reinterpret_cast<uintptr_t>(pthread_get_stackaddr_np(self)) - pthread_get_stacksize_np(self);
+#elif defined(__linux__) && defined(__GLIBC__)
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+        void* stackAddress = nullptr;
+        size_t stackSize = 0;
+        pthread_attr_getstack(&attributes, &stackAddress, &stackSize);
+        pthread_attr_destroy(&attributes);
+        low = reinterpret_cast<uintptr_t>(stackAddress);
+    }
+#endif
+    return low && here > low ? here - low : 0;
+}
+
+void ExecutionFiber::run() {
+    try {
+        entry_();
+    } catch (const Cancelled&) {
+        // Frames unwound on destruction
+    } catch (...) {
+        exception_ = std::current_exception();
+    }
+    finished_ = true;
+}
+
+} // namespace arduino_interpreter
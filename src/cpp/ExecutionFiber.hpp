@@ -0,0 +1,99 @@
+/**
+ * ExecutionFiber.hpp - Suspendable Execution Stack
+ *
+ * The interpreter evaluates the AST recursively, so every pending function
+ * call, block and partially evaluated expression lives in a stack frame. An
+ * ExecutionFiber runs that evaluation on its own heap-allocated stack. When an
+ * external read (analogRead, digitalRead, millis, Serial.read, ...) has to
+ * wait for the parent application, the fiber yields and every frame stays in
+ * place; resuming returns the response from the pending call at whatever depth
+ * it was made, without re-walking the tree or re-evaluating anything.
+ *
+ * POSIX hosts switch stacks with ucontext. Other platforms (ESP-IDF, Windows)
+ * fall back to a dedicated thread with strict hand-off, which keeps the same
+ * "exactly one side runs" semantics; that thread is created with the
+ * requested stack size. Define EXECUTION_FIBER_USE_THREADS to force the
+ * thread backend.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace arduino_interpreter {
+
+class ExecutionFiber {
+public:
+    static constexpr size_t DEFAULT_STACK_SIZE = 1024 * 1024;  // Virtual size; pages commit on use
+
+    explicit ExecutionFiber(std::function<void()> entry, size_t stackSize = DEFAULT_STACK_SIZE);
+
+    /**
+     * Destroying a suspended fiber unwinds its frames (local destructors run):
+     * the fiber is resumed once more and the pending yield() throws Cancelled.
+     */
+    ~ExecutionFiber();
+
+    ExecutionFiber(const ExecutionFiber&) = delete;
+    ExecutionFiber& operator=(const ExecutionFiber&) = delete;
+
+    /**
+     * Run the fiber until it yields or its entry returns. An exception escaping
+     * the entry is rethrown here, on the caller's stack.
+     */
+    void resume();
+
+    /**
+     * Suspend back to the caller of resume(). Must be called from inside the fiber.
+     *
+     * Throws Cancelled when the fiber is destroyed while suspended. Cancelled is
+     * not a std::exception, so `catch (const std::exception&)` lets it through;
+     * code that can reach yield() must not swallow it with `catch (...)`.
+     */
+    void yield();
+
+    bool isStarted() const { return started_; }
+    bool isFinished() const { return finished_; }
+
+    /**
+     * True while the calling code is executing on this fiber's stack
+     */
+    bool isRunning() const { return running_; }
+
+    size_t getStackSize() const { return stackSize_; }
+
+    /**
+     * Bytes left on this fiber's stack below `address`, which must be on it
+     */
+    size_t stackRoom(const void* address) const;
+
+    /**
+     * Bytes left on the calling thread's stack below `address`; 0 when the
+     * platform cannot tell. Not meaningful on a ucontext fiber's stack.
+     */
+    static size_t threadStackRoom(const void* address);
+
+    /** Thrown from yield() to unwind a fiber that is destroyed while suspended */
+    struct Cancelled {};
+
+private:
+    struct Context;
+
+    void run();
+
+    std::function<void()> entry_;
+    size_t stackSize_;
+    std::unique_ptr<Context> context_;
+    std::exception_ptr exception_;
+    bool started_ = false;
+    bool finished_ = false;
+    bool running_ = false;
+    bool cancelRequested_ = false;
+};
+
+} // namespace arduino_interpreter
@@ -193,33 +193,38 @@ public:
 // Global tracer instance
 extern ExecutionTracer g_tracer;
 
-// Convenience macros for tracing
+// Extra condition of the recording macros; a translation unit may redefine it
+// (after including this header) to add its own switch, e.g. a per-object flag
+#define TRACE_GATE() true
+
+// Convenience macros for tracing; details are only built while tracing is enabled
 #define TRACE_ENABLE() g_tracer.enable()
 #define TRACE_DISABLE() g_tracer.disable()  
 #define TRACE_CONTEXT(ctx) g_tracer.setContext(ctx)
-#define TRACE(event, detail) g_tracer.log(event, detail)
-#define TRACE_ENTRY(event, detail) g_tracer.logEntry(event, detail)
-#define TRACE_EXIT(event, detail) g_tracer.logExit(event, detail)  
-#define TRACE_COMMAND(type, details) g_tracer.logCommand(type, details)
-#define TRACE_EXPR(type, details) g_tracer.logExpression(type, details)
+#define TRACE(event, detail) do { if (TRACE_GATE() && g_tracer.isEnabled()) g_tracer.log(event, detail); } while (0)
+#define TRACE_ENTRY(event, detail) do { if (TRACE_GATE() && g_tracer.isEnabled()) g_tracer.logEntry(event, detail); } while (0)
+#define TRACE_EXIT(event, detail) do { if (TRACE_GATE() && g_tracer.isEnabled()) g_tracer.logExit(event, detail); } while (0)
+#define TRACE_COMMAND(type, details) do { if (TRACE_GATE() && g_tracer.isEnabled()) g_tracer.logCommand(type, details); } while (0)
+#define TRACE_EXPR(type, details) do { if (TRACE_GATE() && g_tracer.isEnabled()) g_tracer.logExpression(type, details); } while (0)
 #define TRACE_SAVE(filename) g_tracer.saveToFile(filename)
 #define TRACE_SUMMARY() g_tracer.printSummary()
 #define TRACE_CLEAR() g_tracer.clear()
 
 // RAII helper for automatic entry/exit tracing
 class TraceScope {
-    std::string event_;
+    const char* event_;
+    bool logged_;
 public:
-    TraceScope(const std::string& event, const std::string& detail = "") 
-        : event_(event) {
-        g_tracer.logEntry(event_, detail);
+    TraceScope(const char* event, const char* detail = "", bool gate = true) 
+        : event_(event), logged_(gate && g_tracer.isEnabled()) {
+        if (logged_) g_tracer.logEntry(event_, detail);
     }
     
     ~TraceScope() {
-        g_tracer.logExit(event_, "");
+        if (logged_) g_tracer.logExit(event_, "");
     }
 };
 
-#define TRACE_SCOPE(event, detail) TraceScope _trace_scope(event, detail)
+#define TRACE_SCOPE(event, detail) TraceScope _trace_scope(event, detail, TRACE_GATE())
 
 } // namespace arduino_interpreter
\ No newline at end of file
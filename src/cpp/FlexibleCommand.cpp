@@ -0,0 +1,467 @@
+/**
+ * FlexibleCommand.cpp - Typed command names, comparison and FlexibleCommand views
+ *
+ * Version: 1.0
+ */
+
+#include "FlexibleCommand.hpp"
+#include <mutex>
+#include <unordered_map>
+
+namespace arduino_interpreter {
+
+// =============================================================================
+// COMMAND NAMES
+// =============================================================================
+
+const std::shared_ptr<const std::string>& CommandName::literal(const char* text) {
+    // Each thread remembers the literals it has resolved, by address; only first sightings take the lock
+    thread_local std::unordered_map<const char*, const std::shared_ptr<const std::string>*> seen;
+    auto cached = seen.find(text);
+    if (cached != seen.end() && *cached->second->get() == text) {
+        return *cached->second;
+    }
+
+    static std::mutex poolMutex;
+    static std::unordered_map<std::string, std::shared_ptr<const std::string>> pool;  // Nodes never move
+    const std::shared_ptr<const std::string>* pooled;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        auto& handle = pool[text];
+        if (!handle) {
+            handle = std::make_shared<const std::string>(text);
+        }
+        pooled = &handle;
+    }
+    seen[text] = pooled;
+    return *pooled;
+}
+
+const CommandName& CommandNamePool::get(std::string_view text) {
+    auto found = names_.find(text);
+    if (found == names_.end()) {
+        CommandName name(text);
+        std::string_view key = name.str();
+        found = names_.emplace(key, std::move(name)).first;
+    }
+    return found->second;
+}
+
+// =============================================================================
+// TYPED COMMAND
+// =============================================================================
+
+namespace {
+
+using Kind = TypedCommand::Kind;
+
+const std::string KIND_TYPES[] = {
+    "VERSION_INFO",
+    "PROGRAM_START",
+    "PROGRAM_END",
+    "SETUP_START",
+    "SETUP_END",
+    "LOOP_START",
+    "LOOP_END",
+    "FUNCTION_CALL",
+    "VAR_SET",
+    "PIN_MODE",
+    "DIGITAL_WRITE",
+    "ANALOG_WRITE",
+    "ANALOG_READ_REQUEST",
+    "DIGITAL_READ_REQUEST",
+    "MILLIS_REQUEST",
+    "MICROS_REQUEST",
+    "DELAY",
+    "DELAY_MICROSECONDS",
+    "IF_STATEMENT",
+    "SWITCH_STATEMENT",
+    "SWITCH_CASE",
+    "BREAK_STATEMENT",
+    "CONTINUE_STATEMENT",
+    "SERIAL_REQUEST",
+    "SERIAL_TIMEOUT",
+    "MULTI_SERIAL_BEGIN",
+    "MULTI_SERIAL_PRINT",
+    "MULTI_SERIAL_PRINTLN",
+    "MULTI_SERIAL_REQUEST",
+    "MULTI_SERIAL_COMMAND",
+    "ERROR",
+    "SYSTEM_COMMAND",
+    ""
+};
+
+static_assert(sizeof(KIND_TYPES) / sizeof(KIND_TYPES[0]) == static_cast<size_t>(Kind::KIND_COUNT),
+              "KIND_TYPES must name every TypedCommand::Kind");
+
+const std::string EMPTY;
+
+std::string limitMessage(int32_t iterations) {
+    return "Loop limit reached: completed " + std::to_string(iterations) + " iterations (max: " +
+           std::to_string(iterations) + ")";
+}
+
+// Heap bytes behind one payload member; interned names and scalars own none
+size_t heldBytes(const std::string& text) { return text.size(); }
+size_t heldBytes(const CommandName&) { return 0; }
+
+size_t heldBytes(const std::vector<std::string>& list) {
+    size_t bytes = list.size() * sizeof(std::string);
+    for (const auto& text : list) bytes += text.size();
+    return bytes;
+}
+
+size_t heldBytes(const FlexibleCommandValue& value) {
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        return text->size();
+    }
+    if (const auto* list = std::get_if<TypedCommand::ArgumentList>(&value)) {
+        size_t bytes = list->size() * sizeof(TypedCommand::ArgumentList::value_type);
+        for (const auto& element : *list) {
+            if (const auto* text = std::get_if<std::string>(&element)) bytes += text->size();
+        }
+        return bytes;
+    }
+    return 0;
+}
+
+template<typename T>
+std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>, size_t> heldBytes(const T&) { return 0; }
+
+/** Field set of one payload, as the map-based factories used to build it */
+class ViewBuilder {
+public:
+    ViewBuilder(Kind kind, FlexibleCommand& command) : kind_(kind), command_(command) {}
+
+    void operator()(const TypedCommand::NoFields&) {
+        switch (kind_) {
+            case Kind::PROGRAM_START: command_.set("message", std::string("Program execution started")); break;
+            case Kind::SETUP_START: command_.set("message", std::string("Executing setup() function")); break;
+            case Kind::SETUP_END: command_.set("message", std::string("Completed setup() function")); break;
+            case Kind::BREAK_STATEMENT: command_.set("message", std::string("break")); break;
+            case Kind::CONTINUE_STATEMENT: command_.set("message", std::string("continue")); break;
+            default: break;
+        }
+    }
+
+    void operator()(const TypedCommand::SwitchBreak&) {
+        command_.set("action", std::string("exit_switch"));
+    }
+
+    void operator()(const TypedCommand::SerialFlush&) {
+        command_.set("function", std::string("Serial.flush"))
+                .set("message", std::string("Serial.flush()"));
+    }
+
+    void operator()(const TypedCommand::Text& text) {
+        command_.set("message", text.message);
+    }
+
+    void operator()(const TypedCommand::VersionInfo& info) {
+        command_.set("component", info.component.str())
+                .set("version", info.version.str())
+                .set("status", info.status.str());
+    }
+
+    void operator()(const TypedCommand::LoopStart& loop) {
+        const std::string& type = loop.loopType.str();
+        std::string message;
+        if (type == "main" || type == "loop") {
+            if (loop.iteration == 0) {
+                message = "Starting loop() execution";
+            } else {
+                message = "Starting loop iteration " + std::to_string(loop.iteration);
+            }
+        } else {
+            message = type + " loop started";
+        }
+        command_.set("message", message);
+    }
+
+    void operator()(const TypedCommand::LoopEnd& end) {
+        std::string message = end.message;
+        if (message.empty()) {
+            if (end.limitReached) {
+                message = limitMessage(end.iterations);
+            } else if (end.wording == TypedCommand::LoopEnd::Wording::COMPLETED_AFTER) {
+                message = "Loop completed after " + std::to_string(end.iterations) + " iterations";
+            } else {
+                message = "Completed " + std::to_string(end.iterations) + " loop iterations";
+            }
+        }
+        command_.set("message", message)
+                .set("iterations", end.iterations)
+                .set("limitReached", end.limitReached);
+    }
+
+    void operator()(const TypedCommand::LoopCall& call) {
+        command_.set("function", std::string("loop"))
+                .set("iteration", call.iteration);
+        if (call.completed) {
+            command_.set("message", std::string("Completed loop() iteration ") + std::to_string(call.iteration))
+                    .set("completed", true);
+        } else {
+            command_.set("message", std::string("Executing loop() iteration ") + std::to_string(call.iteration));
+        }
+    }
+
+    void operator()(const TypedCommand::FunctionCall& call) {
+        const std::string& name = call.function.str();
+        command_.set("function", name);
+
+        if (!call.arguments.empty()) {
+            TypedCommand::ArgumentList args;
+            for (const auto& arg : call.arguments) {
+                args.push_back(arg);
+            }
+            command_.set("arguments", args);
+        }
+
+        if (call.iteration > 0) {
+            command_.set("iteration", call.iteration);
+            if (call.completed) {
+                command_.set("completed", true)
+                        .set("message", call.message.empty() ?
+                             ("Completed " + name + "() iteration " + std::to_string(call.iteration)) : call.message);
+            } else {
+                command_.set("message", call.message.empty() ?
+                             ("Executing " + name + "() iteration " + std::to_string(call.iteration)) : call.message);
+            }
+        } else {
+            command_.set("message", call.message.empty() ? (name + "()") : call.message);
+        }
+    }
+
+    void operator()(const TypedCommand::SerialBegin& begin) {
+        command_.set("function", std::string("Serial.begin"))
+                .set("arguments", TypedCommand::ArgumentList{begin.baudRate})
+                .set("baudRate", begin.baudRate)
+                .set("message", std::string("Serial.begin(") + std::to_string(begin.baudRate) + ")");
+    }
+
+    void operator()(const TypedCommand::SerialPrint& print) {
+        command_.set("function", std::string("Serial.print"))
+                .set("arguments", TypedCommand::ArgumentList{print.data})
+                .set("data", print.data)
+                .set("format", print.format.str())
+                .set("message", std::string("Serial.print(") + print.data + ")");
+    }
+
+    void operator()(const TypedCommand::SerialPrintln& print) {
+        command_.set("function", std::string("Serial.println"));
+        if (print.bare) {
+            command_.set("message", std::string("Serial.println()"));
+            return;
+        }
+        command_.set("arguments", TypedCommand::ArgumentList{print.data})
+                .set("data", print.data)
+                .set("message", std::string("Serial.println(") + print.data + ")");
+    }
+
+    void operator()(const TypedCommand::SerialWrite& write) {
+        command_.set("function", std::string("Serial.write"))
+                .set("arguments", TypedCommand::ArgumentList{write.byte})
+                .set("message", std::string("Serial.write(") + std::to_string(write.byte) + ")");
+    }
+
+    void operator()(const TypedCommand::VarSet& set) {
+        command_.set("variable", set.variable.str())
+                .set("value", set.value);
+        if (set.isConst) {
+            command_.set("isConst", true);
+        }
+    }
+
+    void operator()(const TypedCommand::PinValue& pin) {
+        command_.set("pin", pin.pin)
+                .set(kind_ == Kind::PIN_MODE ? "mode" : "value", pin.value);
+    }
+
+    void operator()(const TypedCommand::PinRequest& request) {
+        command_.set("pin", request.pin)
+                .set("requestId", request.requestId);
+    }
+
+    void operator()(const TypedCommand::TimeRequest& request) {
+        command_.set("requestId", request.requestId);
+    }
+
+    void operator()(const TypedCommand::Delay& delay) {
+        command_.set("duration", static_cast<int32_t>(delay.duration));
+        if (kind_ == Kind::DELAY) {
+            command_.set("actualDelay", static_cast<int32_t>(delay.duration));
+        }
+    }
+
+    void operator()(const TypedCommand::IfStatement& statement) {
+        command_.set("condition", statement.condition)
+                .set("result", statement.result)
+                .set("branch", statement.branch.str());
+    }
+
+    void operator()(const TypedCommand::SwitchStatement& statement) {
+        command_.set("discriminant", statement.discriminant)
+                .set("message", "switch (" + statement.discriminantText + ")");
+    }
+
+    void operator()(const TypedCommand::SwitchCase& switchCase) {
+        command_.set("caseValue", switchCase.caseValue)
+                .set("matched", switchCase.matched);
+    }
+
+    void operator()(const TypedCommand::SerialRequest& request) {
+        const std::string& operation = request.operation.str();
+        command_.set("operation", operation)
+                .set("requestId", request.requestId);
+        if (request.hasTerminator) {
+            command_.set("terminator", std::string(1, request.terminator))
+                    .set("message", std::string("Serial.") + operation + "(" + request.terminator + ")");
+        } else {
+            command_.set("message", std::string("Serial.") + operation + "()");
+        }
+    }
+
+    void operator()(const TypedCommand::SerialTimeout& timeout) {
+        command_.set("timeout", timeout.timeout)
+                .set("message", std::string("Serial.setTimeout(") + std::to_string(timeout.timeout) + ")");
+    }
+
+    void operator()(const TypedCommand::Tone& tone) {
+        TypedCommand::ArgumentList args = {tone.pin, tone.frequency};
+        std::string message = std::string("tone(") + std::to_string(tone.pin) + ", " + std::to_string(tone.frequency);
+        if (tone.hasDuration) {
+            args.push_back(tone.duration);
+            message += ", " + std::to_string(tone.duration);
+            command_.set("duration", tone.duration);
+        }
+        command_.set("function", std::string("tone"))
+                .set("arguments", args)
+                .set("pin", tone.pin)
+                .set("frequency", tone.frequency)
+                .set("message", message + ")");
+    }
+
+    void operator()(const TypedCommand::NoTone& noTone) {
+        command_.set("function", std::string("noTone"))
+                .set("arguments", TypedCommand::ArgumentList{noTone.pin})
+                .set("pin", noTone.pin)
+                .set("message", std::string("noTone(") + std::to_string(noTone.pin) + ")");
+    }
+
+    void operator()(const TypedCommand::MultiSerial& serial) {
+        const std::string& port = serial.port.str();
+        const std::string& method = serial.method.str();
+        command_.set("port", port);
+        switch (kind_) {
+            case Kind::MULTI_SERIAL_BEGIN:
+                command_.set("baudRate", serial.baudRate)
+                        .set("message", port + ".begin(" + std::to_string(serial.baudRate) + ")");
+                break;
+            case Kind::MULTI_SERIAL_PRINT:
+            case Kind::MULTI_SERIAL_PRINTLN:
+                command_.set("data", serial.data)
+                        .set("format", method)
+                        .set("message", port + (kind_ == Kind::MULTI_SERIAL_PRINT ? ".print(" : ".println(") +
+                             serial.data + ")");
+                break;
+            case Kind::MULTI_SERIAL_REQUEST:
+                command_.set("operation", method)
+                        .set("requestId", serial.data)
+                        .set("message", port + "." + method + "()");
+                break;
+            default:
+                command_.set("method", method)
+                        .set("message", port + "." + method + "()");
+                break;
+        }
+    }
+
+    void operator()(const TypedCommand::Error& error) {
+        command_.set("message", error.message)
+                .set("errorType", error.errorType.str());
+    }
+
+    void operator()(const TypedCommand::SystemCommand& system) {
+        command_.set("commandType", system.commandType.str())
+                .set("message", system.message);
+    }
+
+    void operator()(const TypedCommand::Declaration&) {}
+
+private:
+    Kind kind_;
+    FlexibleCommand& command_;
+};
+
+} // anonymous namespace
+
+const std::string& TypedCommand::getType() const {
+    if (const auto* declaration = std::get_if<Declaration>(&payload_)) {
+        return declaration->fields.getType();
+    }
+    return KIND_TYPES[static_cast<size_t>(kind_)];
+}
+
+const std::string& TypedCommand::requestId() const {
+    if (const auto* request = std::get_if<PinRequest>(&payload_)) return request->requestId;
+    if (const auto* request = std::get_if<TimeRequest>(&payload_)) return request->requestId;
+    if (const auto* request = std::get_if<SerialRequest>(&payload_)) return request->requestId;
+    if (kind_ == Kind::MULTI_SERIAL_REQUEST) return std::get<MultiSerial>(payload_).data;
+    return EMPTY;
+}
+
+bool TypedCommand::isRequest() const {
+    switch (kind_) {
+        case Kind::ANALOG_READ_REQUEST:
+        case Kind::DIGITAL_READ_REQUEST:
+        case Kind::MILLIS_REQUEST:
+        case Kind::MICROS_REQUEST:
+        case Kind::SERIAL_REQUEST:
+        case Kind::MULTI_SERIAL_REQUEST:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool TypedCommand::sameContent(const TypedCommand& other) const {
+    if (kind_ != other.kind_ || payload_.index() != other.payload_.index()) {
+        return false;
+    }
+    return std::visit([&other](const auto& payload) {
+        using T = std::decay_t<decltype(payload)>;
+        const T& otherPayload = std::get<T>(other.payload_);
+        if constexpr (std::is_same_v<T, Declaration>) {
+            return payload.fields.sameContent(otherPayload.fields);
+        } else {
+            return payload.key() == otherPayload.key();
+        }
+    }, payload_);
+}
+
+size_t TypedCommand::estimatedSize() const {
+    return sizeof(TypedCommand) + std::visit([](const auto& payload) -> size_t {
+        using T = std::decay_t<decltype(payload)>;
+        if constexpr (std::is_same_v<T, Declaration>) {
+            // One map node per field: key, value and the tree links
+            return payload.fields.fieldCount() *
+                   (sizeof(std::string) + sizeof(FlexibleCommandValue) + 4 * sizeof(void*));
+        } else {
+            return std::apply([](const auto&... members) { return (size_t{0} + ... + heldBytes(members)); },
+                              payload.key());
+        }
+    }, payload_);
+}
+
+FlexibleCommand TypedCommand::toFlexibleCommand() const {
+    if (const auto* declaration = std::get_if<Declaration>(&payload_)) {
+        FlexibleCommand view = declaration->fields;
+        view.refreshTimestamp();
+        return view;
+    }
+    FlexibleCommand view(KIND_TYPES[static_cast<size_t>(kind_)]);
+    std::visit(ViewBuilder(kind_, view), payload_);
+    return view;
+}
+
+} // namespace arduino_interpreter
@@ -10,18 +10,27 @@
  * - 7 FUNCTION_CALL variants
  * - 4 VAR_SET variants
  * - 287 unique FUNCTION_CALL message patterns
+ *
+ * The interpreter emits TypedCommand: a kind plus the few values the command
+ * is made from, with identifiers held as shared CommandName handles. The
+ * factories below build those; the map-based FlexibleCommand, with its
+ * timestamp and JSON form, is rendered only for consumers that ask for it.
  */
 
 #pragma once
 
 #include <string>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <string_view>
+#include <tuple>
 
 namespace arduino_interpreter {
 
@@ -92,6 +101,39 @@ public:
      */
     const std::string& getType() const { return type_; }
 
+    /**
+     * Compare type and fields, ignoring the timestamp
+     */
+    bool sameContent(const FlexibleCommand& other) const {
+        if (type_ != other.type_ || fields_.size() != other.fields_.size()) {
+            return false;
+        }
+        for (auto it = fields_.begin(), ot = other.fields_.begin(); it != fields_.end(); ++it, ++ot) {
+            if (it->first != ot->first) {
+                return false;
+            }
+            if (it->first != "timestamp" && it->second != ot->second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Re-stamp a replayed command with the current time
+     */
+    FlexibleCommand& refreshTimestamp() {
+        timestamp_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        fields_["timestamp"] = static_cast<int64_t>(timestamp_);
+        return *this;
+    }
+
+    /**
+     * Number of fields, type and timestamp included
+     */
+    size_t fieldCount() const { return fields_.size(); }
+
     /**
      * Get all field names
      */
@@ -155,6 +197,12 @@ public:
         } else if (cmdType == "IF_STATEMENT") {
             // IF_STATEMENT: type, condition, result, branch, timestamp
             jsOrder = {"type", "condition", "result", "branch", "timestamp"};
+        } else if (cmdType == "SWITCH_STATEMENT") {
+            // SWITCH_STATEMENT: type, discriminant, timestamp, message
+            jsOrder = {"type", "discriminant", "timestamp", "message"};
+        } else if (cmdType == "SWITCH_CASE") {
+            // SWITCH_CASE: type, caseValue, matched, timestamp
+            jsOrder = {"type", "caseValue", "matched", "timestamp"};
         } else {
             // Other commands: type, timestamp, then other fields
             jsOrder = {"type", "timestamp", "component", "version", "status", "message", "requestId", 
@@ -254,544 +302,675 @@ private:
     }
 };
 
+// =============================================================================
+// TYPED COMMANDS
+// =============================================================================
+
+/**
+ * Identifier (variable, function, port or format name) shared by the
+ * commands that carry it, so copying a command never copies the text.
+ * Names spelled in the source code (string literals: formats, branches,
+ * error types) are interned for the life of the process; that set is
+ * bounded by the code. Names made at run time (sketch identifiers) are owned
+ * by their handles and go away with the last command using them; an
+ * interpreter keeps one handle per name in a CommandNamePool.
+ */
+class CommandName {
+public:
+    CommandName() : text_(literal("")) {}
+    template<size_t N>
+    CommandName(const char (&text)[N]) : text_(literal(text)) {}
+    CommandName(std::string_view text) : text_(std::make_shared<const std::string>(text)) {}
+    CommandName(const std::string& text) : CommandName(std::string_view(text)) {}
+
+    const std::string& str() const { return *text_; }
+    bool empty() const { return text_->empty(); }
+
+    bool operator==(const CommandName& other) const { return text_ == other.text_ || *text_ == *other.text_; }
+    bool operator!=(const CommandName& other) const { return !(*this == other); }
+
+private:
+    /** Pooled handle of a string literal; lock-free once the calling thread has seen it */
+    static const std::shared_ptr<const std::string>& literal(const char* text);
+
+    std::shared_ptr<const std::string> text_;
+};
+
+/**
+ * Run-time names one interpreter emits, each made once: every VAR_SET of a
+ * variable shares the same handle. The pool only holds handles, so commands
+ * keep their names after the pool (and its interpreter) is gone.
+ */
+class CommandNamePool {
+public:
+    const CommandName& get(std::string_view text);
+    void clear() { names_.clear(); }
+
+private:
+    std::unordered_map<std::string_view, CommandName> names_;  // Keys view the handles' own text
+};
+
+/**
+ * Fixed-schema command: a kind and the factory arguments that determine its
+ * fields, without a field map or a timestamp. Each kind is one JSON "type";
+ * kinds whose shape varies (FUNCTION_CALL, BREAK_STATEMENT) tell the shapes
+ * apart by payload alternative. toFlexibleCommand() renders the map-based
+ * view, stamped when it is made, for consumers that want fields by name.
+ */
+class TypedCommand {
+public:
+    enum class Kind : uint8_t {
+        VERSION_INFO,
+        PROGRAM_START,
+        PROGRAM_END,
+        SETUP_START,
+        SETUP_END,
+        LOOP_START,
+        LOOP_END,
+        FUNCTION_CALL,
+        VAR_SET,
+        PIN_MODE,
+        DIGITAL_WRITE,
+        ANALOG_WRITE,
+        ANALOG_READ_REQUEST,
+        DIGITAL_READ_REQUEST,
+        MILLIS_REQUEST,
+        MICROS_REQUEST,
+        DELAY,
+        DELAY_MICROSECONDS,
+        IF_STATEMENT,
+        SWITCH_STATEMENT,
+        SWITCH_CASE,
+        BREAK_STATEMENT,
+        CONTINUE_STATEMENT,
+        SERIAL_REQUEST,
+        SERIAL_TIMEOUT,
+        MULTI_SERIAL_BEGIN,
+        MULTI_SERIAL_PRINT,
+        MULTI_SERIAL_PRINTLN,
+        MULTI_SERIAL_REQUEST,
+        MULTI_SERIAL_COMMAND,
+        ERROR,
+        SYSTEM_COMMAND,
+        DECLARATION,    // Declaration-time commands (enum, struct, lambda, ...) kept as a map
+        KIND_COUNT
+    };
+
+    using ArgumentList = std::vector<std::variant<bool, int32_t, double, std::string>>;
+
+    // Payloads; key() lists the members that make two commands equal
+    struct NoFields { auto key() const { return std::tie(); } };
+    struct SwitchBreak { auto key() const { return std::tie(); } };
+    struct SerialFlush { auto key() const { return std::tie(); } };
+    struct Text {
+        std::string message;
+        auto key() const { return std::tie(message); }
+    };
+    struct VersionInfo {
+        CommandName component, version, status;
+        auto key() const { return std::tie(component, version, status); }
+    };
+    struct LoopStart {
+        CommandName loopType;
+        uint32_t iteration;
+        auto key() const { return std::tie(loopType, iteration); }
+    };
+    struct LoopEnd {
+        enum class Wording : uint8_t { COMPLETED_AFTER, COMPLETED_LOOP_ITERATIONS };
+        int32_t iterations;
+        bool limitReached;
+        Wording wording;
+        std::string message;  // Empty: derived from the counts
+        auto key() const { return std::tie(iterations, limitReached, wording, message); }
+    };
+    struct LoopCall {
+        int32_t iteration;
+        bool completed;
+        auto key() const { return std::tie(iteration, completed); }
+    };
+    struct FunctionCall {
+        CommandName function;
+        std::vector<std::string> arguments;
+        int32_t iteration;
+        bool completed;
+        std::string message;  // Empty: derived from the name
+        auto key() const { return std::tie(function, arguments, iteration, completed, message); }
+    };
+    struct SerialBegin {
+        int32_t baudRate;
+        auto key() const { return std::tie(baudRate); }
+    };
+    struct SerialPrint {
+        std::string data;
+        CommandName format;
+        auto key() const { return std::tie(data, format); }
+    };
+    struct SerialPrintln {
+        std::string data;
+        bool bare;  // println() without arguments
+        auto key() const { return std::tie(data, bare); }
+    };
+    struct SerialWrite {
+        int32_t byte;
+        auto key() const { return std::tie(byte); }
+    };
+    struct VarSet {
+        CommandName variable;
+        FlexibleCommandValue value;
+        bool isConst;
+        auto key() const { return std::tie(variable, value, isConst); }
+    };
+    struct PinValue {
+        int32_t pin;
+        int32_t value;  // "mode" of PIN_MODE
+        auto key() const { return std::tie(pin, value); }
+    };
+    struct PinRequest {
+        int32_t pin;
+        std::string requestId;
+        auto key() const { return std::tie(pin, requestId); }
+    };
+    struct TimeRequest {
+        std::string requestId;
+        auto key() const { return std::tie(requestId); }
+    };
+    struct Delay {
+        uint32_t duration;
+        auto key() const { return std::tie(duration); }
+    };
+    struct IfStatement {
+        FlexibleCommandValue condition;
+        bool result;
+        CommandName branch;
+        auto key() const { return std::tie(condition, result, branch); }
+    };
+    struct SwitchStatement {
+        FlexibleCommandValue discriminant;
+        std::string discriminantText;
+        auto key() const { return std::tie(discriminant, discriminantText); }
+    };
+    struct SwitchCase {
+        FlexibleCommandValue caseValue;
+        bool matched;
+        auto key() const { return std::tie(caseValue, matched); }
+    };
+    struct SerialRequest {
+        CommandName operation;
+        std::string requestId;
+        char terminator;
+        bool hasTerminator;
+        auto key() const { return std::tie(operation, requestId, terminator, hasTerminator); }
+    };
+    struct SerialTimeout {
+        int32_t timeout;
+        auto key() const { return std::tie(timeout); }
+    };
+    struct Tone {
+        int32_t pin, frequency, duration;
+        bool hasDuration;
+        auto key() const { return std::tie(pin, frequency, duration, hasDuration); }
+    };
+    struct NoTone {
+        int32_t pin;
+        auto key() const { return std::tie(pin); }
+    };
+    struct MultiSerial {
+        CommandName port;
+        CommandName method;  // Operation of MULTI_SERIAL_REQUEST, format of print/println
+        std::string data;    // Printed text, or the request id of MULTI_SERIAL_REQUEST
+        int32_t baudRate;
+        auto key() const { return std::tie(port, method, data, baudRate); }
+    };
+    struct Error {
+        std::string message;
+        CommandName errorType;
+        auto key() const { return std::tie(message, errorType); }
+    };
+    struct SystemCommand {
+        CommandName commandType;
+        std::string message;
+        auto key() const { return std::tie(commandType, message); }
+    };
+    struct Declaration {
+        FlexibleCommand fields;
+    };
+
+    using Payload = std::variant<
+        NoFields, SwitchBreak, SerialFlush, Text, VersionInfo, LoopStart, LoopEnd, LoopCall,
+        FunctionCall, SerialBegin, SerialPrint, SerialPrintln, SerialWrite, VarSet, PinValue,
+        PinRequest, TimeRequest, Delay, IfStatement, SwitchStatement, SwitchCase, SerialRequest,
+        SerialTimeout, Tone, NoTone, MultiSerial, Error, SystemCommand, Declaration>;
+
+    TypedCommand(Kind kind, Payload payload) : kind_(kind), payload_(std::move(payload)) {}
+
+    Kind kind() const { return kind_; }
+    const Payload& payload() const { return payload_; }
+
+    template<typename T>
+    const T* payloadIf() const { return std::get_if<T>(&payload_); }
+
+    /** JSON "type" of the command */
+    const std::string& getType() const;
+
+    /** Request id of a *_REQUEST command, empty for other kinds */
+    const std::string& requestId() const;
+
+    bool isRequest() const;
+
+    /** Same kind and fields */
+    bool sameContent(const TypedCommand& other) const;
+
+    /** Bytes held by the command and its strings and lists, counted without serializing */
+    size_t estimatedSize() const;
+
+    /** Map-based view with every field of the command, stamped now */
+    FlexibleCommand toFlexibleCommand() const;
+    operator FlexibleCommand() const { return toFlexibleCommand(); }
+
+    // Field access through the view, for consumers written against FlexibleCommand
+    FlexibleCommandValue get(const std::string& key) const { return toFlexibleCommand().get(key); }
+    std::string toJSON() const { return toFlexibleCommand().toJSON(); }
+
+private:
+    Kind kind_;
+    Payload payload_;
+};
+
 /**
  * Factory functions for creating specific command types based on JavaScript patterns
  * These match the exact field combinations found in the analysis
  */
 namespace FlexibleCommandFactory {
 
+    using Kind = TypedCommand::Kind;
+
     // VERSION_INFO: {type, timestamp, component, version, status}
-    inline FlexibleCommand createVersionInfo(const std::string& component, const std::string& version, const std::string& status) {
-        return FlexibleCommand("VERSION_INFO")
-            .set("component", component)
-            .set("version", version)
-            .set("status", status);
+    inline TypedCommand createVersionInfo(const std::string& component, const std::string& version, const std::string& status) {
+        return TypedCommand(Kind::VERSION_INFO, TypedCommand::VersionInfo{component, version, status});
     }
 
     // PROGRAM_START: {type, timestamp, message}
-    inline FlexibleCommand createProgramStart() {
-        return FlexibleCommand("PROGRAM_START")
-            .set("message", std::string("Program execution started"));
+    inline TypedCommand createProgramStart() {
+        return TypedCommand(Kind::PROGRAM_START, TypedCommand::NoFields{});
     }
 
     // SETUP_START: {type, timestamp, message}
-    inline FlexibleCommand createSetupStart() {
-        return FlexibleCommand("SETUP_START")
-            .set("message", std::string("Executing setup() function"));
+    inline TypedCommand createSetupStart() {
+        return TypedCommand(Kind::SETUP_START, TypedCommand::NoFields{});
     }
 
     // SETUP_END: {type, timestamp, message}
-    inline FlexibleCommand createSetupEnd() {
-        return FlexibleCommand("SETUP_END")
-            .set("message", std::string("Completed setup() function"));
+    inline TypedCommand createSetupEnd() {
+        return TypedCommand(Kind::SETUP_END, TypedCommand::NoFields{});
     }
 
     // LOOP_START: {type, timestamp, message} - JavaScript compatible
-    inline FlexibleCommand createLoopStart(const std::string& type, uint32_t iteration = 0) {
-        std::string message;
-        if (type == "main" || type == "loop") {
-            if (iteration == 0) {
-                message = "Starting loop() execution";
-            } else {
-                message = "Starting loop iteration " + std::to_string(iteration);
-            }
-        } else {
-            message = type + " loop started";
-        }
-        return FlexibleCommand("LOOP_START")
-            .set("message", message);
+    inline TypedCommand createLoopStart(CommandName type, uint32_t iteration = 0) {
+        return TypedCommand(Kind::LOOP_START, TypedCommand::LoopStart{type, iteration});
     }
 
     // FUNCTION_CALL variant 1: {type, timestamp, function, arguments, baudRate, message}
-    inline FlexibleCommand createFunctionCallSerialBegin(int32_t baudRate) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {baudRate};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("Serial.begin"))
-            .set("arguments", args)
-            .set("baudRate", baudRate)
-            .set("message", std::string("Serial.begin(") + std::to_string(baudRate) + ")");
+    inline TypedCommand createFunctionCallSerialBegin(int32_t baudRate) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::SerialBegin{baudRate});
     }
 
     // FUNCTION_CALL variant 2: {type, timestamp, function, message, iteration}
-    inline FlexibleCommand createFunctionCallLoop(int32_t iteration, bool completed = false) {
-        FlexibleCommand cmd("FUNCTION_CALL");
-        cmd.set("function", std::string("loop"))
-           .set("iteration", iteration);
-        
-        if (completed) {
-            cmd.set("message", std::string("Completed loop() iteration ") + std::to_string(iteration))
-               .set("completed", true);
-        } else {
-            cmd.set("message", std::string("Executing loop() iteration ") + std::to_string(iteration));
-        }
-        
-        return cmd;
+    inline TypedCommand createFunctionCallLoop(int32_t iteration, bool completed = false) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::LoopCall{iteration, completed});
     }
 
     // FUNCTION_CALL variant 3: {type, timestamp, function, arguments, data, message}
-    inline FlexibleCommand createFunctionCallSerialPrintln(const std::string& data) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {data};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("Serial.println"))
-            .set("arguments", args)
-            .set("data", data)
-            .set("message", std::string("Serial.println(") + data + ")");
+    inline TypedCommand createFunctionCallSerialPrintln(const std::string& data) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::SerialPrintln{data, false});
     }
 
     // FUNCTION_CALL generic: matches old CommandFactory signature
-    inline FlexibleCommand createFunctionCall(const std::string& name, const std::vector<std::string>& argStrings = {}, 
-                                            bool isCompleted = false, int32_t iteration = 0, const std::string& customMessage = "") {
-        FlexibleCommand cmd("FUNCTION_CALL");
-        cmd.set("function", name);
-        
-        if (!argStrings.empty()) {
-            std::vector<std::variant<bool, int32_t, double, std::string>> args;
-            for (const auto& arg : argStrings) {
-                args.push_back(arg);
-            }
-            cmd.set("arguments", args);
-        }
-        
-        if (iteration > 0) {
-            cmd.set("iteration", iteration);
-            if (isCompleted) {
-                cmd.set("completed", true)
-                   .set("message", customMessage.empty() ? 
-                        ("Completed " + name + "() iteration " + std::to_string(iteration)) : customMessage);
-            } else {
-                cmd.set("message", customMessage.empty() ? 
-                        ("Executing " + name + "() iteration " + std::to_string(iteration)) : customMessage);
-            }
-        } else {
-            std::string message = customMessage.empty() ? 
-                (name + "()") : customMessage;
-            cmd.set("message", message);
-        }
-        
-        return cmd;
+    inline TypedCommand createFunctionCall(CommandName name, const std::vector<std::string>& argStrings = {}, 
+                                          bool isCompleted = false, int32_t iteration = 0, const std::string& customMessage = "") {
+        return TypedCommand(Kind::FUNCTION_CALL,
+                            TypedCommand::FunctionCall{name, argStrings, iteration, isCompleted, customMessage});
     }
 
     // VAR_SET variant 1: {type, timestamp, variable, value}
-    inline FlexibleCommand createVarSet(const std::string& variable, const FlexibleCommandValue& value) {
-        return FlexibleCommand("VAR_SET")
-            .set("variable", variable)
-            .set("value", value);
+    inline TypedCommand createVarSet(CommandName variable, const FlexibleCommandValue& value) {
+        return TypedCommand(Kind::VAR_SET, TypedCommand::VarSet{variable, value, false});
     }
 
     // VAR_SET variant 2: {type, timestamp, variable, value, isConst}
-    inline FlexibleCommand createVarSetConst(const std::string& variable, const FlexibleCommandValue& value) {
-        return FlexibleCommand("VAR_SET")
-            .set("variable", variable)
-            .set("value", value)
-            .set("isConst", true);
+    inline TypedCommand createVarSetConst(CommandName variable, const FlexibleCommandValue& value) {
+        return TypedCommand(Kind::VAR_SET, TypedCommand::VarSet{variable, value, true});
     }
 
     // ANALOG_READ_REQUEST: {type, timestamp, pin, requestId}
-    inline FlexibleCommand createAnalogReadRequest(int32_t pin, const std::string& requestId) {
-        return FlexibleCommand("ANALOG_READ_REQUEST")
-            .set("pin", pin)
-            .set("requestId", requestId);
+    inline TypedCommand createAnalogReadRequest(int32_t pin, const std::string& requestId) {
+        return TypedCommand(Kind::ANALOG_READ_REQUEST, TypedCommand::PinRequest{pin, requestId});
     }
 
     // ANALOG_READ_REQUEST: {type, timestamp, pin, requestId} - version with auto-generated ID
-    inline FlexibleCommand createAnalogReadRequest(int32_t pin) {
+    inline TypedCommand createAnalogReadRequest(int32_t pin) {
         std::string requestId = "analogRead_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count()) + "_" + std::to_string(pin);
         return createAnalogReadRequest(pin, requestId);
     }
 
     // DIGITAL_READ_REQUEST: {type, timestamp, pin, requestId}
-    inline FlexibleCommand createDigitalReadRequest(int32_t pin) {
+    inline TypedCommand createDigitalReadRequest(int32_t pin, const std::string& requestId) {
+        return TypedCommand(Kind::DIGITAL_READ_REQUEST, TypedCommand::PinRequest{pin, requestId});
+    }
+
+    // DIGITAL_READ_REQUEST: {type, timestamp, pin, requestId} - version with auto-generated ID
+    inline TypedCommand createDigitalReadRequest(int32_t pin) {
         std::string requestId = "digitalRead_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count()) + "_" + std::to_string(pin);
-        return FlexibleCommand("DIGITAL_READ_REQUEST")
-            .set("pin", pin)
-            .set("requestId", requestId);
+        return createDigitalReadRequest(pin, requestId);
     }
 
     // MILLIS_REQUEST: {type, timestamp, requestId}
-    inline FlexibleCommand createMillisRequest() {
+    inline TypedCommand createMillisRequest(const std::string& requestId) {
+        return TypedCommand(Kind::MILLIS_REQUEST, TypedCommand::TimeRequest{requestId});
+    }
+
+    // MILLIS_REQUEST: {type, timestamp, requestId} - version with auto-generated ID
+    inline TypedCommand createMillisRequest() {
         std::string requestId = "millis_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count());
-        return FlexibleCommand("MILLIS_REQUEST")
-            .set("requestId", requestId);
+        return createMillisRequest(requestId);
     }
 
     // MICROS_REQUEST: {type, timestamp, requestId}
-    inline FlexibleCommand createMicrosRequest() {
+    inline TypedCommand createMicrosRequest(const std::string& requestId) {
+        return TypedCommand(Kind::MICROS_REQUEST, TypedCommand::TimeRequest{requestId});
+    }
+
+    // MICROS_REQUEST: {type, timestamp, requestId} - version with auto-generated ID
+    inline TypedCommand createMicrosRequest() {
         std::string requestId = "micros_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count());
-        return FlexibleCommand("MICROS_REQUEST")
-            .set("requestId", requestId);
+        return createMicrosRequest(requestId);
     }
 
     // PIN_MODE: {type, timestamp, pin, mode}
-    inline FlexibleCommand createPinMode(int32_t pin, int32_t mode) {
-        return FlexibleCommand("PIN_MODE")
-            .set("pin", pin)
-            .set("mode", mode);
+    inline TypedCommand createPinMode(int32_t pin, int32_t mode) {
+        return TypedCommand(Kind::PIN_MODE, TypedCommand::PinValue{pin, mode});
     }
 
     // DIGITAL_WRITE: {type, timestamp, pin, value}
-    inline FlexibleCommand createDigitalWrite(int32_t pin, int32_t value) {
-        return FlexibleCommand("DIGITAL_WRITE")
-            .set("pin", pin)
-            .set("value", value);
+    inline TypedCommand createDigitalWrite(int32_t pin, int32_t value) {
+        return TypedCommand(Kind::DIGITAL_WRITE, TypedCommand::PinValue{pin, value});
     }
 
     // LOOP_END: {type, timestamp, message, iterations, limitReached}
-    inline FlexibleCommand createLoopEnd(int32_t iterations, bool limitReached) {
-        std::string message = limitReached ? 
-            "Loop limit reached: completed " + std::to_string(iterations) + " iterations (max: " + std::to_string(iterations) + ")" :
-            "Loop completed after " + std::to_string(iterations) + " iterations";
-            
-        return FlexibleCommand("LOOP_END")
-            .set("message", message)
-            .set("iterations", iterations)
-            .set("limitReached", limitReached);
+    inline TypedCommand createLoopEnd(int32_t iterations, bool limitReached) {
+        return TypedCommand(Kind::LOOP_END, TypedCommand::LoopEnd{iterations, limitReached,
+                            TypedCommand::LoopEnd::Wording::COMPLETED_AFTER, std::string()});
     }
 
     // LOOP_END: {type, timestamp, message, iterations, limitReached} - JavaScript compatible
-    inline FlexibleCommand createLoopEnd(const std::string& type, uint32_t iterations) {
-        std::string message = "Loop limit reached: completed " + std::to_string(iterations) + 
-                             " iterations (max: " + std::to_string(iterations) + ")";
-        return FlexibleCommand("LOOP_END")
-            .set("message", message)
-            .set("iterations", static_cast<int32_t>(iterations))
-            .set("limitReached", true);
+    inline TypedCommand createLoopEnd(const std::string& type, uint32_t iterations) {
+        return createLoopEnd(static_cast<int32_t>(iterations), true);
     }
 
     // IF_STATEMENT: {type, timestamp, condition, result, branch}
-    inline FlexibleCommand createIfStatement(const FlexibleCommandValue& condition, bool result, const std::string& branch) {
-        return FlexibleCommand("IF_STATEMENT")
-            .set("condition", condition)
-            .set("result", result)
-            .set("branch", branch);
+    inline TypedCommand createIfStatement(const FlexibleCommandValue& condition, bool result, CommandName branch) {
+        return TypedCommand(Kind::IF_STATEMENT, TypedCommand::IfStatement{condition, result, branch});
+    }
+
+    // SWITCH_STATEMENT: {type, discriminant, timestamp, message}
+    inline TypedCommand createSwitchStatement(const FlexibleCommandValue& discriminant, const std::string& discriminantText) {
+        return TypedCommand(Kind::SWITCH_STATEMENT, TypedCommand::SwitchStatement{discriminant, discriminantText});
+    }
+
+    // SWITCH_CASE: {type, caseValue, matched, timestamp} - caseValue is "default" for the default case
+    inline TypedCommand createSwitchCase(const FlexibleCommandValue& caseValue, bool matched) {
+        return TypedCommand(Kind::SWITCH_CASE, TypedCommand::SwitchCase{caseValue, matched});
+    }
+
+    // BREAK_STATEMENT leaving a switch: {type, timestamp, action}
+    inline TypedCommand createSwitchBreak() {
+        return TypedCommand(Kind::BREAK_STATEMENT, TypedCommand::SwitchBreak{});
     }
 
     // PROGRAM_END: {type, timestamp, message}
-    inline FlexibleCommand createProgramEnd(const std::string& message) {
-        return FlexibleCommand("PROGRAM_END")
-            .set("message", message);
+    inline TypedCommand createProgramEnd(const std::string& message) {
+        return TypedCommand(Kind::PROGRAM_END, TypedCommand::Text{message});
     }
 
     // === ADDITIONAL MISSING FUNCTIONS ===
 
     // ANALOG_WRITE: {type, timestamp, pin, value}
-    inline FlexibleCommand createAnalogWrite(int32_t pin, int32_t value) {
-        return FlexibleCommand("ANALOG_WRITE")
-            .set("pin", pin)
-            .set("value", value);
+    inline TypedCommand createAnalogWrite(int32_t pin, int32_t value) {
+        return TypedCommand(Kind::ANALOG_WRITE, TypedCommand::PinValue{pin, value});
     }
 
     // DELAY: {type, timestamp, duration, actualDelay}
-    inline FlexibleCommand createDelay(uint32_t ms) {
-        return FlexibleCommand("DELAY")
-            .set("duration", static_cast<int32_t>(ms))
-            .set("actualDelay", static_cast<int32_t>(ms));
+    inline TypedCommand createDelay(uint32_t ms) {
+        return TypedCommand(Kind::DELAY, TypedCommand::Delay{ms});
     }
 
     // DELAY_MICROSECONDS: {type, timestamp, duration}
-    inline FlexibleCommand createDelayMicroseconds(uint32_t us) {
-        return FlexibleCommand("DELAY_MICROSECONDS")
-            .set("duration", static_cast<int32_t>(us));
+    inline TypedCommand createDelayMicroseconds(uint32_t us) {
+        return TypedCommand(Kind::DELAY_MICROSECONDS, TypedCommand::Delay{us});
     }
 
     // SERIAL OPERATIONS
-    inline FlexibleCommand createSerialBegin(int32_t baudRate) {
+    inline TypedCommand createSerialBegin(int32_t baudRate) {
         return createFunctionCallSerialBegin(baudRate);
     }
 
-    inline FlexibleCommand createSerialPrint(const std::string& data, const std::string& format = "AUTO") {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {data};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("Serial.print"))
-            .set("arguments", args)
-            .set("data", data)
-            .set("format", format)
-            .set("message", std::string("Serial.print(") + data + ")");
+    inline TypedCommand createSerialPrint(const std::string& data, CommandName format = "AUTO") {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::SerialPrint{data, format});
     }
 
-    inline FlexibleCommand createSerialPrintln(const std::string& data, const std::string& format = "AUTO") {
-        if (data.empty() && format == "NEWLINE") {
-            return FlexibleCommand("FUNCTION_CALL")
-                .set("function", std::string("Serial.println"))
-                .set("message", std::string("Serial.println()"));
-        }
-        return createFunctionCallSerialPrintln(data);
+    inline TypedCommand createSerialPrintln(const std::string& data, const std::string& format = "AUTO") {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::SerialPrintln{data, data.empty() && format == "NEWLINE"});
     }
 
-    inline FlexibleCommand createSerialWrite(int32_t byte) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {byte};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("Serial.write"))
-            .set("arguments", args)
-            .set("message", std::string("Serial.write(") + std::to_string(byte) + ")");
+    inline TypedCommand createSerialWrite(int32_t byte) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::SerialWrite{byte});
     }
 
-    inline FlexibleCommand createSerialRequest(const std::string& operation, const std::string& requestId) {
-        return FlexibleCommand("SERIAL_REQUEST")
-            .set("operation", operation)
-            .set("requestId", requestId)
-            .set("message", std::string("Serial.") + operation + "()");
+    inline TypedCommand createSerialRequest(CommandName operation, const std::string& requestId) {
+        return TypedCommand(Kind::SERIAL_REQUEST, TypedCommand::SerialRequest{operation, requestId, '\0', false});
     }
 
-    inline FlexibleCommand createSerialRequestWithChar(const std::string& operation, char terminator, const std::string& requestId) {
-        return FlexibleCommand("SERIAL_REQUEST")
-            .set("operation", operation)
-            .set("terminator", std::string(1, terminator))
-            .set("requestId", requestId)
-            .set("message", std::string("Serial.") + operation + "(" + terminator + ")");
+    inline TypedCommand createSerialRequestWithChar(CommandName operation, char terminator, const std::string& requestId) {
+        return TypedCommand(Kind::SERIAL_REQUEST, TypedCommand::SerialRequest{operation, requestId, terminator, true});
     }
 
-    inline FlexibleCommand createSerialTimeout(int32_t timeout) {
-        return FlexibleCommand("SERIAL_TIMEOUT")
-            .set("timeout", timeout)
-            .set("message", std::string("Serial.setTimeout(") + std::to_string(timeout) + ")");
+    inline TypedCommand createSerialTimeout(int32_t timeout) {
+        return TypedCommand(Kind::SERIAL_TIMEOUT, TypedCommand::SerialTimeout{timeout});
     }
 
-    inline FlexibleCommand createSerialFlush() {
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("Serial.flush"))
-            .set("message", std::string("Serial.flush()"));
+    inline TypedCommand createSerialFlush() {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::SerialFlush{});
     }
 
     // TONE OPERATIONS
-    inline FlexibleCommand createTone(int32_t pin, int32_t frequency) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {pin, frequency};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("tone"))
-            .set("arguments", args)
-            .set("pin", pin)
-            .set("frequency", frequency)
-            .set("message", std::string("tone(") + std::to_string(pin) + ", " + std::to_string(frequency) + ")");
+    inline TypedCommand createTone(int32_t pin, int32_t frequency) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::Tone{pin, frequency, 0, false});
     }
 
-    inline FlexibleCommand createToneWithDuration(int32_t pin, int32_t frequency, int32_t duration) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {pin, frequency, duration};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("tone"))
-            .set("arguments", args)
-            .set("pin", pin)
-            .set("frequency", frequency)
-            .set("duration", duration)
-            .set("message", std::string("tone(") + std::to_string(pin) + ", " + std::to_string(frequency) + ", " + std::to_string(duration) + ")");
+    inline TypedCommand createToneWithDuration(int32_t pin, int32_t frequency, int32_t duration) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::Tone{pin, frequency, duration, true});
     }
 
-    inline FlexibleCommand createNoTone(int32_t pin) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> args = {pin};
-        return FlexibleCommand("FUNCTION_CALL")
-            .set("function", std::string("noTone"))
-            .set("arguments", args)
-            .set("pin", pin)
-            .set("message", std::string("noTone(") + std::to_string(pin) + ")");
+    inline TypedCommand createNoTone(int32_t pin) {
+        return TypedCommand(Kind::FUNCTION_CALL, TypedCommand::NoTone{pin});
     }
 
     // MULTI-SERIAL OPERATIONS
-    inline FlexibleCommand createMultiSerialBegin(const std::string& portName, int32_t baudRate) {
-        return FlexibleCommand("MULTI_SERIAL_BEGIN")
-            .set("port", portName)
-            .set("baudRate", baudRate)
-            .set("message", portName + ".begin(" + std::to_string(baudRate) + ")");
+    inline TypedCommand createMultiSerialBegin(CommandName portName, int32_t baudRate) {
+        return TypedCommand(Kind::MULTI_SERIAL_BEGIN, TypedCommand::MultiSerial{portName, CommandName(), std::string(), baudRate});
     }
 
-    inline FlexibleCommand createMultiSerialPrint(const std::string& portName, const std::string& data, const std::string& format) {
-        return FlexibleCommand("MULTI_SERIAL_PRINT")
-            .set("port", portName)
-            .set("data", data)
-            .set("format", format)
-            .set("message", portName + ".print(" + data + ")");
+    inline TypedCommand createMultiSerialPrint(CommandName portName, const std::string& data, CommandName format) {
+        return TypedCommand(Kind::MULTI_SERIAL_PRINT, TypedCommand::MultiSerial{portName, format, data, 0});
     }
 
-    inline FlexibleCommand createMultiSerialPrintln(const std::string& portName, const std::string& data, const std::string& format) {
-        return FlexibleCommand("MULTI_SERIAL_PRINTLN")
-            .set("port", portName)
-            .set("data", data)
-            .set("format", format)
-            .set("message", portName + ".println(" + data + ")");
+    inline TypedCommand createMultiSerialPrintln(CommandName portName, const std::string& data, CommandName format) {
+        return TypedCommand(Kind::MULTI_SERIAL_PRINTLN, TypedCommand::MultiSerial{portName, format, data, 0});
     }
 
-    inline FlexibleCommand createMultiSerialRequest(const std::string& portName, const std::string& operation, const std::string& requestId) {
-        return FlexibleCommand("MULTI_SERIAL_REQUEST")
-            .set("port", portName)
-            .set("operation", operation)
-            .set("requestId", requestId)
-            .set("message", portName + "." + operation + "()");
+    inline TypedCommand createMultiSerialRequest(CommandName portName, CommandName operation, const std::string& requestId) {
+        return TypedCommand(Kind::MULTI_SERIAL_REQUEST, TypedCommand::MultiSerial{portName, operation, requestId, 0});
     }
 
-    inline FlexibleCommand createMultiSerialCommand(const std::string& portName, const std::string& methodName) {
-        return FlexibleCommand("MULTI_SERIAL_COMMAND")
-            .set("port", portName)
-            .set("method", methodName)
-            .set("message", portName + "." + methodName + "()");
+    inline TypedCommand createMultiSerialCommand(CommandName portName, CommandName methodName) {
+        return TypedCommand(Kind::MULTI_SERIAL_COMMAND, TypedCommand::MultiSerial{portName, methodName, std::string(), 0});
     }
 
     // SYSTEM OPERATIONS
-    inline FlexibleCommand createError(const std::string& message, const std::string& errorType = "RuntimeError") {
-        return FlexibleCommand("ERROR")
-            .set("message", message)
-            .set("errorType", errorType);
+    inline TypedCommand createError(const std::string& message, CommandName errorType = "RuntimeError") {
+        return TypedCommand(Kind::ERROR, TypedCommand::Error{message, errorType});
     }
 
-    inline FlexibleCommand createSystemCommand(const std::string& commandType, const std::string& message) {
-        return FlexibleCommand("SYSTEM_COMMAND")
-            .set("commandType", commandType)
-            .set("message", message);
+    inline TypedCommand createSystemCommand(CommandName commandType, const std::string& message) {
+        return TypedCommand(Kind::SYSTEM_COMMAND, TypedCommand::SystemCommand{commandType, message});
     }
 
     // =============================================================================
     // JAVASCRIPT-COMPATIBLE AST NODE COMMANDS (Added for cross-platform parity)
     // =============================================================================
+    // Emitted once per declaration, so these keep the map-based representation
+
+    inline TypedCommand declaration(FlexibleCommand fields) {
+        return TypedCommand(Kind::DECLARATION, TypedCommand::Declaration{std::move(fields)});
+    }
 
-    inline FlexibleCommand createEnumMember(const std::string& name, const FlexibleCommandValue& value) {
-        return FlexibleCommand("enum_member")
+    inline TypedCommand createEnumMember(const std::string& name, const FlexibleCommandValue& value) {
+        return declaration(FlexibleCommand("enum_member")
             .set("name", name)
-            .set("value", value);
+            .set("value", value));
     }
 
-    inline FlexibleCommand createEnumTypeRef(const std::string& enumName, const std::string& values = "{}") {
-        return FlexibleCommand("enum_type_ref")
+    inline TypedCommand createEnumTypeRef(const std::string& enumName, const std::string& values = "{}") {
+        return declaration(FlexibleCommand("enum_type_ref")
             .set("enumName", enumName)
-            .set("values", values);
+            .set("values", values));
     }
 
-    inline FlexibleCommand createConstructorRegistered(const std::string& className) {
-        return FlexibleCommand("constructor_registered")
-            .set("className", className);
+    inline TypedCommand createConstructorRegistered(const std::string& className) {
+        return declaration(FlexibleCommand("constructor_registered")
+            .set("className", className));
     }
 
-    inline FlexibleCommand createLambdaFunction(const std::vector<std::string>& captures, 
-                                               const std::vector<std::string>& parameters,
-                                               const std::string& bodyDescription = "lambda_body") {
-        std::vector<std::variant<bool, int32_t, double, std::string>> captureArray;
+    inline TypedCommand createLambdaFunction(const std::vector<std::string>& captures, 
+                                            const std::vector<std::string>& parameters,
+                                            const std::string& bodyDescription = "lambda_body") {
+        TypedCommand::ArgumentList captureArray;
         for (const auto& capture : captures) {
             captureArray.push_back(capture);
         }
-        std::vector<std::variant<bool, int32_t, double, std::string>> paramArray;
+        TypedCommand::ArgumentList paramArray;
         for (const auto& param : parameters) {
             paramArray.push_back(param);
         }
         
-        return FlexibleCommand("lambda_function")
+        return declaration(FlexibleCommand("lambda_function")
             .set("captures", captureArray)
             .set("parameters", paramArray)
-            .set("body", bodyDescription);
+            .set("body", bodyDescription));
     }
 
-    inline FlexibleCommand createMemberFunctionRegistered(const std::string& className, const std::string& methodName) {
-        return FlexibleCommand("member_function_registered")
+    inline TypedCommand createMemberFunctionRegistered(const std::string& className, const std::string& methodName) {
+        return declaration(FlexibleCommand("member_function_registered")
             .set("className", className)
-            .set("methodName", methodName);
+            .set("methodName", methodName));
     }
 
-    inline FlexibleCommand createDynamicArray(const std::string& elementType, int32_t size) {
-        return FlexibleCommand("dynamic_array")
+    inline TypedCommand createDynamicArray(const std::string& elementType, int32_t size) {
+        return declaration(FlexibleCommand("dynamic_array")
             .set("elementType", elementType)
             .set("size", size)
-            .set("isHeapAllocated", true);
+            .set("isHeapAllocated", true));
     }
 
-    inline FlexibleCommand createObjectInstance(const std::string& className, 
-                                               const std::vector<std::variant<bool, int32_t, double, std::string>>& args) {
-        return FlexibleCommand("object_instance")
+    inline TypedCommand createObjectInstance(const std::string& className, const TypedCommand::ArgumentList& args) {
+        return declaration(FlexibleCommand("object_instance")
             .set("className", className)
             .set("arguments", args)
-            .set("isHeapAllocated", true);
+            .set("isHeapAllocated", true));
     }
 
-    inline FlexibleCommand createRangeExpression(const FlexibleCommandValue& start, const FlexibleCommandValue& end) {
-        return FlexibleCommand("range")
+    inline TypedCommand createRangeExpression(const FlexibleCommandValue& start, const FlexibleCommandValue& end) {
+        return declaration(FlexibleCommand("range")
             .set("start", start)
-            .set("end", end);
+            .set("end", end));
     }
 
-    inline FlexibleCommand createMultipleStructMembers(const std::vector<std::string>& members, const std::string& memberType = "unknown") {
-        std::vector<std::variant<bool, int32_t, double, std::string>> memberArray;
+    inline TypedCommand createMultipleStructMembers(const std::vector<std::string>& members, const std::string& memberType = "unknown") {
+        TypedCommand::ArgumentList memberArray;
         for (const auto& member : members) {
             memberArray.push_back(member);
         }
         
-        return FlexibleCommand("multiple_struct_members")
+        return declaration(FlexibleCommand("multiple_struct_members")
             .set("members", memberArray)
-            .set("memberType", memberType);
+            .set("memberType", memberType));
     }
 
-    inline FlexibleCommand createStructMember(const std::string& memberName, const std::string& memberType, int32_t size = 4) {
-        return FlexibleCommand("struct_member")
+    inline TypedCommand createStructMember(const std::string& memberName, const std::string& memberType, int32_t size = 4) {
+        return declaration(FlexibleCommand("struct_member")
             .set("memberName", memberName)
             .set("memberType", memberType)
-            .set("size", size);
+            .set("size", size));
     }
 
-    inline FlexibleCommand createTemplateTypeParam(const std::string& paramName, const std::string& constraint = "") {
-        return FlexibleCommand("template_type_param")
+    inline TypedCommand createTemplateTypeParam(const std::string& paramName, const std::string& constraint = "") {
+        return declaration(FlexibleCommand("template_type_param")
             .set("paramName", paramName)
-            .set("constraint", constraint);
+            .set("constraint", constraint));
     }
 
-    inline FlexibleCommand createUnionDefinition(const std::string& unionName, 
-                                                const std::vector<std::string>& members,
-                                                const std::vector<std::string>& variables = {}) {
-        std::vector<std::variant<bool, int32_t, double, std::string>> memberArray;
+    inline TypedCommand createUnionDefinition(const std::string& unionName, 
+                                             const std::vector<std::string>& members,
+                                             const std::vector<std::string>& variables = {}) {
+        TypedCommand::ArgumentList memberArray;
         for (const auto& member : members) {
             memberArray.push_back(member);
         }
-        std::vector<std::variant<bool, int32_t, double, std::string>> variableArray;
+        TypedCommand::ArgumentList variableArray;
         for (const auto& variable : variables) {
             variableArray.push_back(variable);
         }
         
-        return FlexibleCommand("union_definition")
+        return declaration(FlexibleCommand("union_definition")
             .set("name", unionName)
             .set("members", memberArray)
             .set("variables", variableArray)
-            .set("isUnion", true);
+            .set("isUnion", true));
     }
 
-    inline FlexibleCommand createUnionTypeRef(const std::string& unionName, int32_t size = 8) {
-        return FlexibleCommand("union_type_ref")
+    inline TypedCommand createUnionTypeRef(const std::string& unionName, int32_t size = 8) {
+        return declaration(FlexibleCommand("union_type_ref")
             .set("unionName", unionName)
-            .set("size", size);
+            .set("size", size));
     }
 
-    inline FlexibleCommand createPreprocessorError(const std::string& directiveType, const std::string& message) {
-        return FlexibleCommand("ERROR")
-            .set("errorType", "PreprocessorError")
-            .set("message", std::string("Unexpected PreprocessorDirective AST node: ") + directiveType + ". " + message);
+    inline TypedCommand createPreprocessorError(const std::string& directiveType, const std::string& message) {
+        return createError(std::string("Unexpected PreprocessorDirective AST node: ") + directiveType + ". " + message,
+                           "PreprocessorError");
     }
 
     // =============================================================================
     // ADDITIONAL SYSTEM COMMAND FACTORY METHODS (JavaScript Compatibility)
     // =============================================================================
 
-    inline FlexibleCommand createVersionInfo(const std::string& version = "1.0.0", const std::string& component = "interpreter") {
-        return FlexibleCommand("VERSION_INFO")
-            .set("component", component)
-            .set("version", version)
-            .set("status", std::string("started"));
+    inline TypedCommand createVersionInfo(const std::string& version = "1.0.0", const std::string& component = "interpreter") {
+        return createVersionInfo(component, version, std::string("started"));
     }
 
-    inline FlexibleCommand createLoopEndComplete(int32_t iterations, bool limitReached = false, const std::string& message = "") {
-        std::string msg = message.empty() ? 
-            (limitReached ? 
-                ("Loop limit reached: completed " + std::to_string(iterations) + " iterations (max: " + std::to_string(iterations) + ")") :
-                ("Completed " + std::to_string(iterations) + " loop iterations")
-            ) : message;
-        
-        return FlexibleCommand("LOOP_END")
-            .set("iterations", iterations)
-            .set("limitReached", limitReached)
-            .set("message", msg);
+    inline TypedCommand createLoopEndComplete(int32_t iterations, bool limitReached = false, const std::string& message = "") {
+        return TypedCommand(Kind::LOOP_END, TypedCommand::LoopEnd{iterations, limitReached,
+                            TypedCommand::LoopEnd::Wording::COMPLETED_LOOP_ITERATIONS, message});
     }
 
-    inline FlexibleCommand createBreakStatement() {
-        return FlexibleCommand("BREAK_STATEMENT")
-            .set("message", std::string("break"));
+    inline TypedCommand createBreakStatement() {
+        return TypedCommand(Kind::BREAK_STATEMENT, TypedCommand::NoFields{});
     }
 
-    inline FlexibleCommand createContinueStatement() {
-        return FlexibleCommand("CONTINUE_STATEMENT")
-            .set("message", std::string("continue"));
+    inline TypedCommand createContinueStatement() {
+        return TypedCommand(Kind::CONTINUE_STATEMENT, TypedCommand::NoFields{});
     }
 
 } // namespace FlexibleCommandFactory
@@ -816,6 +995,13 @@ public:
     virtual ~FlexibleCommandListener() = default;
     virtual void onCommand(const FlexibleCommand& command) = 0;
     virtual void onError(const std::string& error) = 0;
+    
+    /**
+     * Every command the interpreter emits arrives here first. Override it to
+     * consume typed commands; the default builds the FlexibleCommand view for
+     * onCommand().
+     */
+    virtual void onTypedCommand(const TypedCommand& command) { onCommand(command.toFlexibleCommand()); }
 };
 
 } // namespace arduino_interpreter
\ No newline at end of file
@@ -0,0 +1,404 @@
+/**
+ * InterpreterFarm.cpp - Work-stealing scheduler for interpreter instances
+ */
+
+#include "InterpreterFarm.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+
+namespace arduino_interpreter {
+
+// =============================================================================
+// INTERNAL STATE
+// =============================================================================
+
+struct InterpreterFarm::Instance {
+    FarmInstanceId id = 0;
+    std::unique_ptr<ASTInterpreter> interpreter;
+    std::unique_ptr<InstanceListener> listener;
+
+    // Responses waiting to be handed to the interpreter; guarded by inboxMutex
+    std::mutex inboxMutex;
+    std::vector<std::pair<std::string, CommandValue>> inbox;
+    bool parked = false;
+
+    // Touched only by the worker currently running the instance. Output is
+    // batched per instance so a board's stream stays in order however it
+    // migrates between workers.
+    std::vector<FarmCommand> output;
+    Worker* worker = nullptr;           // Running the current slice (the fiber may be another thread)
+    uint64_t pendingDelayMicros = 0;
+    uint32_t lastLoopIteration = 0;
+};
+
+struct InterpreterFarm::Worker {
+    size_t index = 0;
+    std::thread thread;
+
+    std::mutex queueMutex;
+    std::deque<Instance*> queue;        // Owner pops the front, thieves take the back
+
+    std::atomic<uint64_t> slices{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> parks{0};
+    std::atomic<uint64_t> loopIterations{0};
+    std::atomic<uint64_t> commands{0};
+};
+
+namespace {
+
+void addRelaxed(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+uint64_t durationField(const TypedCommand& command) {
+    // The command carries the duration as a signed int: negative delays do not park
+    const auto* delay = command.payloadIf<TypedCommand::Delay>();
+    int32_t duration = delay ? static_cast<int32_t>(delay->duration) : 0;
+    return duration > 0 ? static_cast<uint64_t>(duration) : 0;
+}
+
+} // anonymous namespace
+
+/**
+ * Per-instance listener: batches output on the running worker, answers
+ * requests through the responder and turns delays into virtual-time parking
+ */
+class InterpreterFarm::InstanceListener : public FlexibleCommandListener {
+public:
+    InstanceListener(InterpreterFarm& farm, Instance& instance) : farm_(farm), instance_(instance) {}
+
+    void onTypedCommand(const TypedCommand& command) override {
+        Worker* worker = instance_.worker;
+        if (!worker) {
+            return;
+        }
+
+        if (farm_.options_.virtualDelays) {
+            if (command.kind() == TypedCommand::Kind::DELAY) {
+                instance_.pendingDelayMicros += durationField(command) * 1000;
+                instance_.interpreter->requestPreemption();
+            } else if (command.kind() == TypedCommand::Kind::DELAY_MICROSECONDS) {
+                instance_.pendingDelayMicros += durationField(command);
+                instance_.interpreter->requestPreemption();
+            }
+        }
+
+        if (farm_.responder_ && command.isRequest()) {
+            CommandValue value;
+            if (farm_.responder_(instance_.id, command, value)) {
+                std::lock_guard<std::mutex> lock(instance_.inboxMutex);
+                instance_.inbox.emplace_back(command.requestId(), std::move(value));
+            }
+        }
+
+        instance_.output.push_back(FarmCommand{instance_.id, command});
+        if (instance_.output.size() >= farm_.options_.outputBatchSize) {
+            farm_.flushOutput(*worker, instance_);
+        }
+    }
+
+    void onCommand(const FlexibleCommand&) override {
+        // Commands arrive typed through onTypedCommand()
+    }
+
+    void onError(const std::string&) override {
+        // Errors also arrive as ERROR commands through onTypedCommand()
+    }
+
+private:
+    InterpreterFarm& farm_;
+    Instance& instance_;
+};
+
+// =============================================================================
+// CONSTRUCTION
+// =============================================================================
+
+InterpreterFarm::InterpreterFarm(const FarmOptions& options) : options_(options) {
+    if (options_.workerCount == 0) {
+        options_.workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options_.outputBatchSize == 0) {
+        options_.outputBatchSize = 1;
+    }
+}
+
+InterpreterFarm::~InterpreterFarm() {
+    stop();
+}
+
+FarmInstanceId InterpreterFarm::addInstance(std::unique_ptr<ASTInterpreter> interpreter) {
+    auto instance = std::make_unique<Instance>();
+    instance->id = static_cast<FarmInstanceId>(instances_.size());
+    instance->interpreter = std::move(interpreter);
+    instance->listener = std::make_unique<InstanceListener>(*this, *instance);
+    instance->interpreter->setCommandListener(instance->listener.get());
+    if (!options_.traceInstances) {
+        // g_tracer is shared and unsynchronised; worker threads must not record into it
+        instance->interpreter->setExecutionTracing(false);
+    }
+
+    Instance& added = *instance;
+    instances_.push_back(std::move(instance));
+    liveInstances_.fetch_add(1);
+
+    if (started_) {
+        enqueue(added, nullptr);
+    }
+    return added.id;
+}
+
+ASTInterpreter* InterpreterFarm::getInterpreter(FarmInstanceId id) const {
+    return id < instances_.size() ? instances_[id]->interpreter.get() : nullptr;
+}
+
+// =============================================================================
+// LIFECYCLE
+// =============================================================================
+
+void InterpreterFarm::start() {
+    if (started_) {
+        return;
+    }
+    started_ = true;
+    stopping_.store(false);
+
+    if (workers_.empty()) {
+        for (size_t i = 0; i < options_.workerCount; ++i) {
+            auto worker = std::make_unique<Worker>();
+            worker->index = i;
+            workers_.push_back(std::move(worker));
+        }
+        for (auto& instance : instances_) {
+            enqueue(*instance, nullptr);
+        }
+    }
+
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w]() { workerLoop(*w); });
+    }
+}
+
+void InterpreterFarm::wait() {
+    std::unique_lock<std::mutex> lock(idleMutex_);
+    doneCv_.wait(lock, [this]() { return liveInstances_.load() == 0; });
+}
+
+void InterpreterFarm::stop() {
+    if (!started_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        stopping_.store(true);
+    }
+    idleCv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    for (auto& instance : instances_) {
+        flushOutput(*workers_.front(), *instance);
+    }
+    started_ = false;
+}
+
+void InterpreterFarm::deliverResponse(FarmInstanceId id, const std::string& requestId, const CommandValue& value) {
+    if (id >= instances_.size()) {
+        return;
+    }
+    Instance& instance = *instances_[id];
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(instance.inboxMutex);
+        instance.inbox.emplace_back(requestId, value);
+        wake = instance.parked;
+        instance.parked = false;
+    }
+    if (wake) {
+        enqueue(instance, nullptr);
+    }
+}
+
+InterpreterFarm::FarmStats InterpreterFarm::getStats() const {
+    FarmStats stats{};
+    for (const auto& worker : workers_) {
+        stats.slices += worker->slices.load(std::memory_order_relaxed);
+        stats.steals += worker->steals.load(std::memory_order_relaxed);
+        stats.parks += worker->parks.load(std::memory_order_relaxed);
+        stats.loopIterations += worker->loopIterations.load(std::memory_order_relaxed);
+        stats.commands += worker->commands.load(std::memory_order_relaxed);
+    }
+    stats.instancesCompleted = completed_.load();
+    stats.virtualTimeMicros = getVirtualTimeMicros();
+    return stats;
+}
+
+// =============================================================================
+// SCHEDULING
+// =============================================================================
+
+void InterpreterFarm::workerLoop(Worker& worker) {
+    while (!stopping_.load()) {
+        Instance* instance = popLocal(worker);
+        if (!instance) {
+            instance = steal(worker);
+        }
+        if (instance) {
+            runInstance(worker, *instance);
+            running_.fetch_sub(1);
+            continue;
+        }
+
+        if (advanceVirtualClock()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idleWorkers_.fetch_add(1);
+        if (queued_.load() == 0 && !stopping_.load()) {
+            idleCv_.wait(lock);
+        }
+        idleWorkers_.fetch_sub(1);
+    }
+}
+
+InterpreterFarm::Instance* InterpreterFarm::popLocal(Worker& worker) {
+    std::lock_guard<std::mutex> lock(worker.queueMutex);
+    if (worker.queue.empty()) {
+        return nullptr;
+    }
+    Instance* instance = worker.queue.front();
+    worker.queue.pop_front();
+    running_.fetch_add(1);  // Before queued_ drops, so the farm never looks idle mid-handoff
+    queued_.fetch_sub(1);
+    return instance;
+}
+
+InterpreterFarm::Instance* InterpreterFarm::steal(Worker& thief) {
+    size_t count = workers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(thief.index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.queueMutex);
+        if (victim.queue.empty()) {
+            continue;
+        }
+        Instance* instance = victim.queue.back();
+        victim.queue.pop_back();
+        running_.fetch_add(1);
+        queued_.fetch_sub(1);
+        addRelaxed(thief.steals, 1);
+        return instance;
+    }
+    return nullptr;
+}
+
+void InterpreterFarm::enqueue(Instance& instance, Worker* preferred) {
+    Worker& target = preferred ? *preferred
+                               : *workers_[nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+    queued_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(target.queueMutex);
+        target.queue.push_back(&instance);
+    }
+    if (idleWorkers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        idleCv_.notify_one();
+    }
+}
+
+void InterpreterFarm::runInstance(Worker& worker, Instance& instance) {
+    ASTInterpreter& interpreter = *instance.interpreter;
+    instance.worker = &worker;
+
+    std::vector<std::pair<std::string, CommandValue>> responses;
+    {
+        std::lock_guard<std::mutex> lock(instance.inboxMutex);
+        responses.swap(instance.inbox);
+    }
+    for (auto& response : responses) {
+        interpreter.handleResponse(response.first, response.second);
+    }
+
+    bool more = options_.sliceTime.count() > 0 ? interpreter.tickFor(options_.sliceTime)
+                                               : interpreter.tickSteps(options_.sliceSteps);
+    addRelaxed(worker.slices, 1);
+
+    uint32_t iteration = interpreter.getLoopIteration();
+    addRelaxed(worker.loopIterations, iteration - instance.lastLoopIteration);
+    instance.lastLoopIteration = iteration;
+
+    if (!more) {
+        flushOutput(worker, instance);
+        finishInstance();
+        return;
+    }
+
+    if (instance.pendingDelayMicros > 0) {
+        flushOutput(worker, instance);
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        timers_.emplace_back(virtualTimeMicros_.load() + instance.pendingDelayMicros, &instance);
+        std::push_heap(timers_.begin(), timers_.end(), std::greater<std::pair<uint64_t, Instance*>>());
+        instance.pendingDelayMicros = 0;
+        addRelaxed(worker.parks, 1);
+        return;
+    }
+
+    if (interpreter.isWaitingForResponse()) {
+        flushOutput(worker, instance);
+        std::lock_guard<std::mutex> lock(instance.inboxMutex);
+        if (instance.inbox.empty()) {
+            instance.parked = true;  // deliverResponse() requeues it
+            addRelaxed(worker.parks, 1);
+            return;
+        }
+    }
+
+    enqueue(instance, &worker);
+}
+
+bool InterpreterFarm::advanceVirtualClock() {
+    std::lock_guard<std::mutex> lock(timerMutex_);
+    if (timers_.empty() || queued_.load() != 0 || running_.load() != 0) {
+        return false;
+    }
+
+    // Every board is blocked in delay(): jump straight to the earliest wake time
+    auto later = std::greater<std::pair<uint64_t, Instance*>>();
+    uint64_t wakeTime = timers_.front().first;
+    virtualTimeMicros_.store(wakeTime, std::memory_order_release);
+    while (!timers_.empty() && timers_.front().first <= wakeTime) {
+        Instance* instance = timers_.front().second;
+        std::pop_heap(timers_.begin(), timers_.end(), later);
+        timers_.pop_back();
+        enqueue(*instance, nullptr);
+    }
+    return true;
+}
+
+void InterpreterFarm::flushOutput(Worker& worker, Instance& instance) {
+    if (instance.output.empty()) {
+        return;
+    }
+    if (sink_) {
+        sink_(instance.output);
+    }
+    addRelaxed(worker.commands, instance.output.size());
+    instance.output.clear();
+}
+
+void InterpreterFarm::finishInstance() {
+    completed_.fetch_add(1);
+    if (liveInstances_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        doneCv_.notify_all();
+    }
+}
+
+} // namespace arduino_interpreter
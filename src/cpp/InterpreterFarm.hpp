@@ -0,0 +1,156 @@
+/**
+ * InterpreterFarm.hpp - Multi-core runtime for fleets of interpreter instances
+ *
+ * Runs many ASTInterpreter instances (one per simulated board) on a fixed pool
+ * of worker threads instead of one caller loop per interpreter:
+ *
+ *   - every worker owns a run queue of ready instances and steals from the
+ *     other workers when its own queue runs dry
+ *   - each dispatch runs one budgeted slice (tickSteps/tickFor), so a busy
+ *     sketch cannot monopolise a worker
+ *   - instances waiting on a response, or on a virtual-time delay(), are
+ *     parked off the queues until the response is delivered or the virtual
+ *     clock reaches their wake time; idle workers sleep instead of spinning
+ *   - commands are handed to the sink in batches, in order per instance
+ *
+ * Host-side component (needs std::thread); not part of the embedded build.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include "ASTInterpreter.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace arduino_interpreter {
+
+using FarmInstanceId = uint32_t;
+
+/**
+ * Command emitted by one farm instance
+ */
+struct FarmCommand {
+    FarmInstanceId instance;
+    TypedCommand command;  // toFlexibleCommand() for the field map and JSON
+};
+
+struct FarmOptions {
+    size_t workerCount = 0;                     // 0 = std::thread::hardware_concurrency()
+    uint64_t sliceSteps = 256;                  // Preemption points per dispatch
+    std::chrono::microseconds sliceTime{0};     // Wall-clock slice instead of sliceSteps when non-zero
+    size_t outputBatchSize = 256;               // Commands buffered per instance before the sink runs
+    bool virtualDelays = true;                  // delay()/delayMicroseconds() park on the virtual clock
+    bool traceInstances = false;                // Let instances record into g_tracer (only safe with one worker)
+};
+
+class InterpreterFarm {
+public:
+    /** Receives batches of commands; called concurrently from worker threads */
+    using CommandSink = std::function<void(const std::vector<FarmCommand>&)>;
+
+    /**
+     * Answers a *_REQUEST command in place (e.g. simulated sensors). Return
+     * false to answer later through deliverResponse().
+     */
+    using RequestResponder = std::function<bool(FarmInstanceId, const TypedCommand&, CommandValue&)>;
+
+    struct FarmStats {
+        uint64_t slices;
+        uint64_t steals;
+        uint64_t parks;
+        uint64_t loopIterations;
+        uint64_t commands;
+        size_t instancesCompleted;
+        uint64_t virtualTimeMicros;
+    };
+
+    explicit InterpreterFarm(const FarmOptions& options = FarmOptions());
+    ~InterpreterFarm();
+
+    InterpreterFarm(const InterpreterFarm&) = delete;
+    InterpreterFarm& operator=(const InterpreterFarm&) = delete;
+
+    /**
+     * Take ownership of an interpreter; it is started by its first slice.
+     * Add instances before start().
+     */
+    FarmInstanceId addInstance(std::unique_ptr<ASTInterpreter> interpreter);
+
+    void setCommandSink(CommandSink sink) { sink_ = std::move(sink); }
+    void setRequestResponder(RequestResponder responder) { responder_ = std::move(responder); }
+
+    /**
+     * Deliver a response to a parked instance (thread-safe)
+     */
+    void deliverResponse(FarmInstanceId id, const std::string& requestId, const CommandValue& value);
+
+    /**
+     * Launch the worker threads
+     */
+    void start();
+
+    /**
+     * Block until every instance has completed (instances parked on a
+     * deliverResponse() that never arrives keep this waiting)
+     */
+    void wait();
+
+    /**
+     * Stop the workers; unfinished instances stay where they are
+     */
+    void stop();
+
+    ASTInterpreter* getInterpreter(FarmInstanceId id) const;
+    size_t getWorkerCount() const { return workers_.size(); }
+    uint64_t getVirtualTimeMicros() const { return virtualTimeMicros_.load(std::memory_order_acquire); }
+    FarmStats getStats() const;
+
+private:
+    struct Instance;
+    struct Worker;
+    class InstanceListener;
+
+    void workerLoop(Worker& worker);
+    Instance* popLocal(Worker& worker);
+    Instance* steal(Worker& thief);
+    void runInstance(Worker& worker, Instance& instance);
+    void enqueue(Instance& instance, Worker* preferred);
+    bool advanceVirtualClock();
+    void flushOutput(Worker& worker, Instance& instance);
+    void finishInstance();
+
+    FarmOptions options_;
+    CommandSink sink_;
+    RequestResponder responder_;
+
+    std::vector<std::unique_ptr<Instance>> instances_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> nextWorker_{0};
+
+    // Run-state accounting: queued + running never drops to zero while work is in flight
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> running_{0};
+    std::atomic<size_t> liveInstances_{0};
+    std::atomic<size_t> completed_{0};
+    std::atomic<size_t> idleWorkers_{0};
+    std::atomic<bool> stopping_{false};
+    bool started_ = false;
+
+    std::mutex idleMutex_;
+    std::condition_variable idleCv_;
+    std::condition_variable doneCv_;
+
+    // Virtual clock (discrete-event): advances to the earliest wake time once
+    // no instance is runnable
+    std::mutex timerMutex_;
+    std::vector<std::pair<uint64_t, Instance*>> timers_;  // min-heap on wake time
+    std::atomic<uint64_t> virtualTimeMicros_{0};
+};
+
+} // namespace arduino_interpreter
@@ -0,0 +1,113 @@
+/**
+ * RefCounted.hpp - Intrusive reference counting for runtime heap objects
+ *
+ * Arrays, structs, String objects and pointers in EnhancedCommandValue are
+ * shared between variables, elements and temporaries, so every copy of such
+ * a value adjusts a reference count. std::shared_ptr does that with a locked
+ * read-modify-write and keeps the count in a separate control block; here
+ * the count lives in the object and is a plain integer.
+ *
+ * Like Value, the counts are not atomic: objects belong to the interpreter
+ * that created them and are only touched from the thread running it (the
+ * fiber hand-off of the thread backend orders all accesses). Freeze a value
+ * into a CommandValue to hand it to another thread.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace arduino_interpreter {
+
+/**
+ * Base of reference-counted objects. A copy of an object is a new object
+ * and starts unreferenced.
+ */
+class RefCounted {
+public:
+    uint32_t refCount() const { return refs_; }
+
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) noexcept {}
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+    ~RefCounted() = default;
+
+private:
+    template<typename> friend class Ref;
+    mutable uint32_t refs_ = 0;
+};
+
+/**
+ * Owning handle of a RefCounted object; deletes it with the last handle
+ */
+template<typename T>
+class Ref {
+public:
+    Ref() noexcept = default;
+    Ref(std::nullptr_t) noexcept {}
+    explicit Ref(T* object) noexcept : object_(object) { retain(); }
+
+    Ref(const Ref& other) noexcept : object_(other.object_) { retain(); }
+    Ref(Ref&& other) noexcept : object_(other.object_) { other.object_ = nullptr; }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Ref(const Ref<U>& other) noexcept : object_(other.get()) { retain(); }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Ref(Ref<U>&& other) noexcept : object_(other.detach()) {}
+
+    ~Ref() { release(); }
+
+    Ref& operator=(const Ref& other) noexcept {
+        Ref(other).swap(*this);
+        return *this;
+    }
+
+    Ref& operator=(Ref&& other) noexcept {
+        Ref(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    T* get() const noexcept { return object_; }
+    T& operator*() const noexcept { return *object_; }
+    T* operator->() const noexcept { return object_; }
+    explicit operator bool() const noexcept { return object_ != nullptr; }
+
+    void reset() noexcept { Ref().swap(*this); }
+    void swap(Ref& other) noexcept { std::swap(object_, other.object_); }
+
+    /** Give up ownership without releasing */
+    T* detach() noexcept {
+        T* object = object_;
+        object_ = nullptr;
+        return object;
+    }
+
+    friend bool operator==(const Ref& a, const Ref& b) noexcept { return a.object_ == b.object_; }
+    friend bool operator!=(const Ref& a, const Ref& b) noexcept { return a.object_ != b.object_; }
+
+private:
+    void retain() const noexcept {
+        if (object_) ++object_->refs_;
+    }
+
+    void release() noexcept {
+        if (object_ && --object_->refs_ == 0) delete object_;
+    }
+
+    T* object_ = nullptr;
+};
+
+/** New object owned by the returned handle */
+template<typename T, typename... Args>
+Ref<T> makeRef(Args&&... args) {
+    return Ref<T>(new T(std::forward<Args>(args)...));
+}
+
+} // namespace arduino_interpreter
@@ -0,0 +1,376 @@
+/**
+ * SimulatedMemory.cpp - Byte-addressable RAM of the simulated board
+ *
+ * Version: 1.0
+ */
+
+#include "SimulatedMemory.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace arduino_interpreter {
+
+// =============================================================================
+// SIMULATED MEMORY
+// =============================================================================
+
+namespace {
+
+unsigned highestBit(size_t value) {
+    return 31u - static_cast<unsigned>(__builtin_clz(static_cast<uint32_t>(value)));
+}
+
+unsigned lowestBit(uint32_t value) {
+    return static_cast<unsigned>(__builtin_ctz(value));
+}
+
+size_t roundToGranule(size_t size) {
+    return std::max<size_t>((size + SimulatedMemory::ALIGNMENT - 1) & ~(SimulatedMemory::ALIGNMENT - 1),
+                            SimulatedMemory::ALIGNMENT);
+}
+
+} // anonymous namespace
+
+SimulatedMemory::SimulatedMemory(size_t capacity)
+    : capacity_(std::min<size_t>(capacity, UINT32_MAX - BASE_ADDRESS) & ~(ALIGNMENT - 1)),
+      end_(BASE_ADDRESS + static_cast<uint32_t>(capacity_)),
+      largestFree_(capacity_) {
+}
+
+void SimulatedMemory::materialize() {
+    // All of RAM starts as one free block
+    bytes_.reset(new uint8_t[capacity_]());
+    if (capacity_ > 0) {
+        header(BASE_ADDRESS).size = static_cast<uint32_t>(capacity_) | FREE;
+        insertFree(BASE_ADDRESS);
+    }
+}
+
+void SimulatedMemory::sizeClass(size_t size, unsigned& fl, unsigned& sl) {
+    if (size < SMALL_BLOCK) {
+        fl = 0;
+        sl = static_cast<unsigned>(size / ALIGNMENT);
+    } else {
+        unsigned bit = highestBit(size);
+        sl = static_cast<unsigned>(size >> (bit - SL_BITS)) ^ SL_COUNT;
+        fl = bit - FL_SHIFT + 1;
+    }
+}
+
+void SimulatedMemory::insertFree(uint32_t address) {
+    unsigned fl, sl;
+    sizeClass(sizeOf(header(address)), fl, sl);
+    Header& block = header(address);
+    block.previousFree = 0;
+    block.nextFree = freeLists_[fl][sl];
+    if (block.nextFree) {
+        header(block.nextFree).previousFree = address;
+    }
+    freeLists_[fl][sl] = address;
+    flBitmap_ |= 1u << fl;
+    slBitmaps_[fl] |= 1u << sl;
+    largestFree_ = std::max<size_t>(largestFree_, sizeOf(block));
+}
+
+void SimulatedMemory::removeFree(uint32_t address) {
+    Header& block = header(address);
+    if (block.nextFree) {
+        header(block.nextFree).previousFree = block.previousFree;
+    }
+    if (block.previousFree) {
+        header(block.previousFree).nextFree = block.nextFree;
+    } else {
+        unsigned fl, sl;
+        sizeClass(sizeOf(block), fl, sl);
+        freeLists_[fl][sl] = block.nextFree;
+        if (!block.nextFree) {
+            slBitmaps_[fl] &= ~(1u << sl);
+            if (!slBitmaps_[fl]) flBitmap_ &= ~(1u << fl);
+        }
+    }
+    block.nextFree = block.previousFree = 0;
+    
+    // The next largest block is in the highest class still holding one
+    if (sizeOf(block) == largestFree_) {
+        largestFree_ = 0;
+        if (flBitmap_) {
+            unsigned fl = highestBit(flBitmap_);
+            for (uint32_t other = freeLists_[fl][highestBit(slBitmaps_[fl])]; other; other = header(other).nextFree) {
+                largestFree_ = std::max<size_t>(largestFree_, sizeOf(header(other)));
+            }
+        }
+    }
+}
+
+uint32_t SimulatedMemory::takeFree(size_t size) {
+    // Round the request up to the next class boundary so any block found fits (good fit, O(1))
+    unsigned fl, sl;
+    size_t search = size >= SMALL_BLOCK ? size + (size_t(1) << (highestBit(size) - SL_BITS)) - 1 : size;
+    uint32_t found = 0;
+    if (search <= capacity_) {
+        sizeClass(search, fl, sl);
+        uint32_t slMap = fl < FL_COUNT ? slBitmaps_[fl] & (~0u << sl) : 0;
+        if (!slMap) {
+            uint32_t flMap = fl + 1 < FL_COUNT ? flBitmap_ & (~0u << (fl + 1)) : 0;
+            if (flMap) {
+                fl = lowestBit(flMap);
+                slMap = slBitmaps_[fl];
+            }
+        }
+        if (slMap) {
+            found = freeLists_[fl][lowestBit(slMap)];
+        }
+    }
+    
+    // Nearly all of RAM asked for: the request's own class may still hold a block that fits
+    if (!found) {
+        sizeClass(size, fl, sl);
+        for (uint32_t address = freeLists_[fl][sl]; address; address = header(address).nextFree) {
+            if (sizeOf(header(address)) >= size) {
+                found = address;
+                break;
+            }
+        }
+    }
+    if (found) {
+        removeFree(found);
+    }
+    return found;
+}
+
+uint32_t SimulatedMemory::mergeFree(uint32_t address) {
+    // address is a free block outside the lists; absorb free neighbours on both sides
+    uint32_t size = sizeOf(header(address));
+    uint32_t next = address + size;
+    if (next < end_ && isFree(header(next))) {
+        removeFree(next);
+        size += sizeOf(header(next));
+        headers_.erase(next);
+    }
+    uint32_t previous = header(address).previous;
+    if (previous && isFree(header(previous))) {
+        removeFree(previous);
+        size += sizeOf(header(previous));
+        headers_.erase(address);
+        address = previous;
+    }
+    header(address).size = size | FREE;
+    if (address + size < end_) {
+        header(address + size).previous = address;
+    }
+    return address;
+}
+
+void SimulatedMemory::trim(uint32_t address, uint32_t size) {
+    // Split an allocated block at size; the tail goes back to the free lists
+    Header& block = header(address);
+    uint32_t total = sizeOf(block);
+    if (total - size < ALIGNMENT) return;
+    
+    block.size = size;
+    uint32_t tail = address + size;
+    header(tail) = Header{(total - size) | FREE, address, 0, 0};
+    if (tail + (total - size) < end_) {
+        header(tail + (total - size)).previous = tail;
+    }
+    insertFree(mergeFree(tail));
+}
+
+bool SimulatedMemory::isAllocated(uint32_t address) const {
+    auto block = headers_.find(address);
+    return block != headers_.end() && !isFree(block->second);
+}
+
+uint32_t SimulatedMemory::allocate(size_t size) {
+    if (size > capacity_) {
+        failedAllocations_++;
+        return 0;
+    }
+    if (!bytes_) {
+        materialize();
+    }
+    uint32_t rounded = static_cast<uint32_t>(roundToGranule(size));
+    uint32_t address = takeFree(rounded);
+    if (!address) {
+        failedAllocations_++;
+        return 0;
+    }
+    
+    header(address).size &= ~FREE;
+    trim(address, rounded);
+    used_ += rounded;
+    peak_ = std::max(peak_, used_);
+    liveBlocks_++;
+    allocations_++;
+    std::memset(at(address), 0, rounded);
+    return address;
+}
+
+void SimulatedMemory::release(uint32_t address) {
+    if (!isAllocated(address)) return;
+    
+    Header& block = header(address);
+    used_ -= sizeOf(block);
+    liveBlocks_--;
+    block.size |= FREE;
+    insertFree(mergeFree(address));
+}
+
+uint32_t SimulatedMemory::reallocate(uint32_t address, size_t size) {
+    if (address == 0) return allocate(size);
+    if (!isAllocated(address)) return 0;
+    if (size == 0) {
+        release(address);
+        return 0;
+    }
+    if (size > capacity_) {
+        failedAllocations_++;
+        return 0;
+    }
+    
+    uint32_t current = sizeOf(header(address));
+    uint32_t rounded = static_cast<uint32_t>(roundToGranule(size));
+    if (rounded <= current) {
+        trim(address, rounded);
+        used_ -= current - sizeOf(header(address));
+        std::memset(at(address) + size, 0, sizeOf(header(address)) - size);
+        return address;
+    }
+    
+    // Grow into the free block above when it is large enough
+    uint32_t next = address + current;
+    if (next < end_ && isFree(header(next)) && current + sizeOf(header(next)) >= rounded) {
+        uint32_t combined = current + sizeOf(header(next));
+        removeFree(next);
+        headers_.erase(next);
+        header(address).size = combined;
+        if (address + combined < end_) {
+            header(address + combined).previous = address;
+        }
+        trim(address, rounded);
+        std::memset(at(address) + current, 0, rounded - current);
+        used_ += rounded - current;
+        peak_ = std::max(peak_, used_);
+        return address;
+    }
+    
+    uint32_t moved = allocate(size);
+    if (moved) {
+        std::memcpy(at(moved), at(address), current);
+        release(address);
+    }
+    return moved;
+}
+
+size_t SimulatedMemory::blockSize(uint32_t address) const {
+    return isAllocated(address) ? sizeOf(header(address)) : 0;
+}
+
+SimulatedMemory::Stats SimulatedMemory::stats() const {
+    Stats stats;
+    stats.capacity = capacity_;
+    stats.liveBytes = used_;
+    stats.peakBytes = peak_;
+    stats.freeBytes = capacity_ - used_;
+    stats.largestFreeBlock = largestFree_;
+    stats.liveBlocks = liveBlocks_;
+    stats.allocations = allocations_;
+    stats.failedAllocations = failedAllocations_;
+    return stats;
+}
+
+// =============================================================================
+// MEMORY BLOCK
+// =============================================================================
+
+MemoryBlock::MemoryBlock(SimulatedMemory* memory, size_t size) : memory_(memory), size_(size) {
+    if (size_ == 0) return;
+    if (memory_) {
+        address_ = memory_->allocate(size_);
+        if (address_ == 0) {
+            throw std::bad_alloc();
+        }
+        data_ = memory_->at(address_);
+    } else {
+        host_.resize(size_);
+        data_ = host_.data();
+    }
+}
+
+MemoryBlock::MemoryBlock(const MemoryBlock& other) : MemoryBlock(other.memory_, other.size_) {
+    if (size_ > 0) {
+        std::memcpy(data_, other.data_, size_);
+    }
+}
+
+MemoryBlock::MemoryBlock(MemoryBlock&& other) noexcept
+    : memory_(other.memory_), address_(other.address_), data_(other.data_), size_(other.size_),
+      host_(std::move(other.host_)) {
+    other.address_ = 0;
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MemoryBlock& MemoryBlock::operator=(const MemoryBlock& other) {
+    if (this != &other) {
+        *this = MemoryBlock(other);
+    }
+    return *this;
+}
+
+MemoryBlock& MemoryBlock::operator=(MemoryBlock&& other) noexcept {
+    if (this != &other) {
+        reset();
+        memory_ = other.memory_;
+        address_ = other.address_;
+        data_ = other.data_;
+        size_ = other.size_;
+        host_ = std::move(other.host_);
+        other.address_ = 0;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+MemoryBlock::~MemoryBlock() {
+    reset();
+}
+
+void MemoryBlock::reset() {
+    if (memory_ && address_ != 0) {
+        memory_->release(address_);
+    }
+    address_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void MemoryBlock::resize(size_t newSize) {
+    if (newSize == size_) return;
+    if (!memory_) {
+        host_.resize(newSize);
+        data_ = host_.data();
+        size_ = newSize;
+        return;
+    }
+    if (newSize == 0 || address_ == 0) {
+        *this = MemoryBlock(memory_, newSize);
+        return;
+    }
+    
+    // realloc(): in place when the neighbouring block is free
+    uint32_t address = memory_->reallocate(address_, newSize);
+    if (address == 0) {
+        throw std::bad_alloc();
+    }
+    address_ = address;
+    data_ = memory_->at(address_);
+    if (newSize > size_) {
+        std::memset(data_ + size_, 0, newSize - size_);
+    }
+    size_ = newSize;
+}
+
+} // namespace arduino_interpreter
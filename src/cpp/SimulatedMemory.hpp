@@ -0,0 +1,196 @@
+/**
+ * SimulatedMemory.hpp - Byte-addressable RAM of the simulated board
+ *
+ * Declared arrays and malloc() blocks live in one flat buffer sized to the
+ * target's SRAM (2 KB on an ATmega328P, 512 KB on an ESP32). A pointer is a
+ * plain 32-bit address into it: pointer arithmetic is integer math, a
+ * dereference is a bounds check and a load at a fixed offset, and memset/
+ * memcpy run as bulk operations on the buffer. Addresses stay valid for the
+ * lifetime of the block, unlike pointers into the variable store.
+ *
+ * Addresses start at BASE_ADDRESS (the first SRAM address of the AVR parts),
+ * so NULL and small integers never name a valid location.
+ *
+ * Blocks come from a TLSF (two-level segregated fit) allocator: free blocks
+ * sit in lists by size class, found through two bitmaps, so allocate,
+ * release and reallocate are constant time whatever the heap looks like.
+ * Freed blocks merge with free neighbours at once. Block headers are kept
+ * beside the RAM, not in it, one per block keyed by its address, so a sketch
+ * writing past its buffer corrupts its neighbour's data but never the
+ * allocator. The RAM itself is only allocated by the first allocate(): most
+ * sketches never call malloc() or declare an array. Stats report the live
+ * and peak heap and the largest free block, all kept up to date as blocks
+ * come and go: on a 2 KB board a heap that keeps free bytes but no large
+ * block is the one that crashes.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace arduino_interpreter {
+
+class SimulatedMemory {
+public:
+    static constexpr uint32_t BASE_ADDRESS = 0x100;
+    static constexpr size_t ALIGNMENT = 8;  // Widest packed element (double)
+
+    /** Heap occupancy; sizes are in bytes of whole blocks */
+    struct Stats {
+        size_t capacity = 0;
+        size_t liveBytes = 0;
+        size_t peakBytes = 0;            // Highest liveBytes so far
+        size_t freeBytes = 0;
+        size_t largestFreeBlock = 0;     // Largest allocation that can still succeed
+        size_t liveBlocks = 0;
+        uint64_t allocations = 0;        // Successful allocations, including moves by reallocate()
+        uint64_t failedAllocations = 0;
+
+        /** Share of the free bytes a single allocation cannot use (0: one free block) */
+        double fragmentation() const {
+            return freeBytes ? 1.0 - static_cast<double>(largestFreeBlock) / static_cast<double>(freeBytes) : 0.0;
+        }
+    };
+
+    explicit SimulatedMemory(size_t capacity);
+
+    SimulatedMemory(const SimulatedMemory&) = delete;
+    SimulatedMemory& operator=(const SimulatedMemory&) = delete;
+
+    /** Zero-filled block of size bytes, or 0 when no free block is large enough */
+    uint32_t allocate(size_t size);
+
+    /** Return a block from allocate(); other addresses are ignored */
+    void release(uint32_t address);
+
+    /**
+     * C realloc(): grow or shrink in place when the neighbouring space allows,
+     * else move the contents to a new block. Bytes past the old size read as
+     * zero. Returns 0 and leaves the block alone when RAM is exhausted;
+     * address 0 allocates, size 0 releases.
+     */
+    uint32_t reallocate(uint32_t address, size_t size);
+
+    /** Size of the block starting at address (0 when it is not an allocated block) */
+    size_t blockSize(uint32_t address) const;
+
+    Stats stats() const;
+
+    /** [address, address + size) lies inside RAM (none does before the first allocation) */
+    bool contains(uint32_t address, size_t size) const {
+        return bytes_ && address >= BASE_ADDRESS && address - BASE_ADDRESS <= capacity_ &&
+               size <= capacity_ - (address - BASE_ADDRESS);
+    }
+
+    /** Host location of address; check contains() first */
+    uint8_t* at(uint32_t address) { return bytes_.get() + (address - BASE_ADDRESS); }
+    const uint8_t* at(uint32_t address) const { return bytes_.get() + (address - BASE_ADDRESS); }
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+
+    /** Call fn(address, bytes, size) for every allocated block, in address order */
+    template<typename Fn>
+    void forEachBlock(Fn&& fn) const {
+        if (!bytes_) return;
+        for (uint32_t address = BASE_ADDRESS; address < end_; address += sizeOf(header(address))) {
+            if (!isFree(header(address))) {
+                fn(address, at(address), sizeOf(header(address)));
+            }
+        }
+    }
+
+private:
+    static constexpr unsigned SL_BITS = 4;                          // 16 size classes per power of two
+    static constexpr unsigned SL_COUNT = 1u << SL_BITS;
+    static constexpr unsigned FL_SHIFT = SL_BITS + 3;               // log2(SL_COUNT * ALIGNMENT)
+    static constexpr size_t SMALL_BLOCK = size_t(1) << FL_SHIFT;    // Smaller classes are ALIGNMENT apart
+    static constexpr unsigned FL_COUNT = 32 - FL_SHIFT + 1;
+    static constexpr uint32_t FREE = 1;                             // Flag in the low bit of Header::size
+
+    /** Boundary tag of a block, stored under the address the block starts at */
+    struct Header {
+        uint32_t size = 0;          // Block bytes | FREE
+        uint32_t previous = 0;      // Block just below in RAM (0 for the first)
+        uint32_t nextFree = 0;      // Free list links of a free block
+        uint32_t previousFree = 0;
+    };
+
+    static uint32_t sizeOf(const Header& header) { return header.size & ~FREE; }
+    static bool isFree(const Header& header) { return (header.size & FREE) != 0; }
+    static void sizeClass(size_t size, unsigned& fl, unsigned& sl);
+
+    Header& header(uint32_t address) { return headers_[address]; }
+    const Header& header(uint32_t address) const { return headers_.find(address)->second; }
+    bool isAllocated(uint32_t address) const;
+
+    void materialize();
+
+    void insertFree(uint32_t address);
+    void removeFree(uint32_t address);
+    uint32_t takeFree(size_t size);
+    uint32_t mergeFree(uint32_t address);
+    void trim(uint32_t address, uint32_t size);
+
+    std::unique_ptr<uint8_t[]> bytes_;      // Null until the first allocation
+    size_t capacity_;
+    uint32_t end_;                          // One past the last RAM address
+    std::unordered_map<uint32_t, Header> headers_;  // One per block, free or allocated
+    uint32_t flBitmap_ = 0;                 // First-level classes with a free block
+    uint32_t slBitmaps_[FL_COUNT] = {};     // Second-level classes with a free block
+    uint32_t freeLists_[FL_COUNT][SL_COUNT] = {};
+    size_t used_ = 0;
+    size_t peak_ = 0;
+    size_t largestFree_ = 0;
+    size_t liveBlocks_ = 0;
+    uint64_t allocations_ = 0;
+    uint64_t failedAllocations_ = 0;
+};
+
+/**
+ * Byte buffer of a data-model object: a block of simulated RAM when one is
+ * attached, host memory otherwise (objects created outside an interpreter).
+ * Copies get their own block in the same RAM.
+ */
+class MemoryBlock {
+public:
+    MemoryBlock() = default;
+
+    /** Zero-filled buffer; throws std::bad_alloc when the simulated RAM is exhausted */
+    MemoryBlock(SimulatedMemory* memory, size_t size);
+
+    MemoryBlock(const MemoryBlock& other);
+    MemoryBlock(MemoryBlock&& other) noexcept;
+    MemoryBlock& operator=(const MemoryBlock& other);
+    MemoryBlock& operator=(MemoryBlock&& other) noexcept;
+    ~MemoryBlock();
+
+    /** Keep the first min(size, newSize) bytes, zero-fill the rest */
+    void resize(size_t newSize);
+
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    uint8_t& operator[](size_t index) { return data_[index]; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+
+    /** Simulated address of the first byte (0 for host memory) */
+    uint32_t address() const { return address_; }
+
+private:
+    void reset();
+
+    SimulatedMemory* memory_ = nullptr;
+    uint32_t address_ = 0;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<uint8_t> host_;  // Storage without simulated RAM
+};
+
+} // namespace arduino_interpreter
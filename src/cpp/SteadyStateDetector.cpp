@@ -0,0 +1,131 @@
+/**
+ * SteadyStateDetector.cpp - Periodic loop() detection for fast-forwarding
+ */
+
+#include "SteadyStateDetector.hpp"
+#include <algorithm>
+
+namespace arduino_interpreter {
+
+SteadyStateDetector::SteadyStateDetector(uint32_t maxPeriod, uint32_t confirmations)
+    : maxPeriod_(std::max<uint32_t>(1, maxPeriod)), confirmations_(std::max<uint32_t>(2, confirmations)) {
+}
+
+void SteadyStateDetector::beginIteration(size_t variableMemory, size_t commandMemory) {
+    current_.commands.clear();
+    startVariableMemory_ = variableMemory;
+    startCommandMemory_ = commandMemory;
+    tainted_ = false;
+    recording_ = true;
+}
+
+void SteadyStateDetector::record(const TypedCommand& command) {
+    if (recording_) {
+        current_.commands.push_back(command);
+    }
+}
+
+void SteadyStateDetector::closeIteration(uint64_t stateFingerprint, size_t variableMemory, size_t commandMemory) {
+    recording_ = false;
+    current_.fingerprint = stateFingerprint;
+    current_.variableMemoryGrowth = variableMemory - startVariableMemory_;
+    current_.commandMemoryGrowth = commandMemory - startCommandMemory_;
+    current_.tainted = tainted_;
+}
+
+void SteadyStateDetector::endIteration(uint64_t stateFingerprint, size_t variableMemory, size_t commandMemory) {
+    closeIteration(stateFingerprint, variableMemory, commandMemory);
+
+    history_.push_back(std::move(current_));
+    current_ = IterationRecord();
+    while (history_.size() > static_cast<size_t>(maxPeriod_) * confirmations_) {
+        history_.pop_front();
+    }
+
+    period_ = 0;
+    phase_ = 0;
+    if (!history_.back().tainted) {
+        detectPeriod();
+    }
+}
+
+bool SteadyStateDetector::verifyIteration(uint64_t stateFingerprint, size_t variableMemory, size_t commandMemory) {
+    closeIteration(stateFingerprint, variableMemory, commandMemory);
+
+    bool matched = isLocked() && !current_.tainted && sameIteration(current_, template_[phase_]);
+    if (matched) {
+        phase_ = (phase_ + 1) % period_;
+        return true;
+    }
+
+    // Template no longer describes the program: start detecting from scratch
+    reset();
+    return false;
+}
+
+const SteadyStateDetector::IterationRecord& SteadyStateDetector::nextTemplateIteration() {
+    const IterationRecord& record = template_[phase_];
+    phase_ = (phase_ + 1) % period_;
+    return record;
+}
+
+void SteadyStateDetector::reset() {
+    history_.clear();
+    current_ = IterationRecord();
+    recording_ = false;
+    tainted_ = false;
+    period_ = 0;
+    phase_ = 0;
+    template_.clear();
+    cycleMemoryGrowth_ = 0;
+}
+
+bool SteadyStateDetector::sameIteration(const IterationRecord& a, const IterationRecord& b) {
+    if (a.fingerprint != b.fingerprint || a.commands.size() != b.commands.size() ||
+        a.variableMemoryGrowth != b.variableMemoryGrowth) {
+        return false;
+    }
+    for (size_t i = 0; i < a.commands.size(); ++i) {
+        if (!a.commands[i].sameContent(b.commands[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SteadyStateDetector::detectPeriod() {
+    size_t count = history_.size();
+
+    for (uint32_t period = 1; period <= maxPeriod_; ++period) {
+        size_t window = static_cast<size_t>(period) * confirmations_;
+        if (window > count) {
+            break;
+        }
+
+        // The last `confirmations_` blocks of `period` iterations must be identical,
+        // untainted, and end in the same state at the same phase
+        bool periodic = true;
+        for (size_t k = 0; k < window && periodic; ++k) {
+            const IterationRecord& record = history_[count - 1 - k];
+            if (record.tainted) {
+                periodic = false;
+            } else if (k + period < window) {
+                periodic = sameIteration(record, history_[count - 1 - k - period]);
+            }
+        }
+
+        if (periodic) {
+            period_ = period;
+            phase_ = 0;
+            template_.assign(history_.end() - period, history_.end());
+            cycleMemoryGrowth_ = 0;
+            for (const auto& record : template_) {
+                cycleMemoryGrowth_ += record.variableMemoryGrowth + record.commandMemoryGrowth;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace arduino_interpreter
@@ -0,0 +1,106 @@
+/**
+ * SteadyStateDetector.hpp - Periodic loop() detection for fast-forwarding
+ *
+ * Many sketches (Blink, fades, LED chases) settle into a cycle of P loop()
+ * iterations that emit the same commands from the same global state. The
+ * detector records the body commands of each iteration together with a
+ * fingerprint of the persistent state (globals, statics) at its end. Once the
+ * last P iterations have repeated identically for the configured number of
+ * periods, the cycle is locked and its commands become a template: the
+ * interpreter can replay whole periods instead of re-executing the AST.
+ *
+ * Iterations that observe anything outside the fingerprinted state (external
+ * reads, random(), errors) are tainted and never take part in a cycle. The
+ * growth of the interpreter's memory accounting is recorded per iteration so
+ * a replay can be refused when it would cross the memory limit.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include "FlexibleCommand.hpp"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace arduino_interpreter {
+
+class SteadyStateDetector {
+public:
+    struct IterationRecord {
+        std::vector<TypedCommand> commands;
+        uint64_t fingerprint = 0;
+        size_t variableMemoryGrowth = 0;
+        size_t commandMemoryGrowth = 0;
+        bool tainted = false;
+    };
+
+    SteadyStateDetector(uint32_t maxPeriod, uint32_t confirmations);
+
+    /**
+     * Start recording the body commands of one loop() iteration
+     */
+    void beginIteration(size_t variableMemory, size_t commandMemory);
+
+    void record(const TypedCommand& command);
+
+    /**
+     * Mark the current iteration as depending on state outside the fingerprint
+     */
+    void taint() { tainted_ = true; }
+
+    bool isRecording() const { return recording_; }
+
+    /**
+     * Close the current iteration with the persistent-state fingerprint after
+     * it and look for a cycle ending here
+     */
+    void endIteration(uint64_t stateFingerprint, size_t variableMemory, size_t commandMemory);
+
+    /**
+     * Verification mode: close the current iteration by checking it against
+     * the locked template. A mismatch unlocks the cycle.
+     * @return true if the executed iteration matched the template
+     */
+    bool verifyIteration(uint64_t stateFingerprint, size_t variableMemory, size_t commandMemory);
+
+    /**
+     * Next templated iteration; advances the cycle phase
+     */
+    const IterationRecord& nextTemplateIteration();
+
+    bool isLocked() const { return period_ > 0; }
+    uint32_t getPeriod() const { return period_; }
+    uint32_t getPhase() const { return phase_; }
+
+    /**
+     * Memory accounting growth of one whole locked cycle
+     */
+    size_t getCycleMemoryGrowth() const { return cycleMemoryGrowth_; }
+
+    void reset();
+
+private:
+    void closeIteration(uint64_t stateFingerprint, size_t variableMemory, size_t commandMemory);
+    static bool sameIteration(const IterationRecord& a, const IterationRecord& b);
+    bool detectPeriod();
+
+    uint32_t maxPeriod_;
+    uint32_t confirmations_;
+
+    std::deque<IterationRecord> history_;
+    IterationRecord current_;
+    size_t startVariableMemory_ = 0;
+    size_t startCommandMemory_ = 0;
+    bool recording_ = false;
+    bool tainted_ = false;
+
+    // Locked cycle
+    uint32_t period_ = 0;
+    uint32_t phase_ = 0;
+    std::vector<IterationRecord> template_;
+    size_t cycleMemoryGrowth_ = 0;
+};
+
+} // namespace arduino_interpreter
@@ -0,0 +1,420 @@
+/**
+ * TargetProfiles.hpp - Arduino Target Data-Model Profiles
+ *
+ * Compile-time policies describing the C data model of the simulated board:
+ * integer widths, floating point precision and unsigned wraparound. The
+ * interpreter instantiates evaluateBinaryOperation, convertToType and
+ * getDefaultValueForType once per profile and binds the instantiation at
+ * construction, so width handling is resolved by the compiler instead of
+ * being re-checked on every operation.
+ *
+ *   host  - JavaScript-compatible semantics (all arithmetic in double),
+ *           produces command streams identical to ASTInterpreter.js
+ *   avr8  - Arduino Uno/Mega: 16-bit int, 32-bit long, float == double == 32-bit
+ *   esp32 - ESP32/ESP32-S3: 32-bit int and long, 32-bit float, 64-bit double
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include "Value.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace arduino_interpreter {
+
+/**
+ * Runtime selector for the data-model profile (see InterpreterOptions)
+ */
+enum class TargetProfile : uint8_t {
+    HOST = 0,
+    AVR8 = 1,
+    ESP32 = 2
+};
+
+/**
+ * Value kind a declared C type converts to, resolved once per declaration by
+ * the static type inference pass. UNKNOWN keeps the dynamic variant as-is.
+ */
+enum class StaticType : uint8_t {
+    UNKNOWN = 0,
+    BOOL,
+    INT,
+    UNSIGNED_INT,
+    LONG,
+    UNSIGNED_LONG,
+    SHORT,
+    UNSIGNED_SHORT,
+    BYTE,
+    INT8,
+    CHAR,       // Signed 8-bit, but appended to a String as a character
+    INT32,
+    UINT32,
+    FLOAT,
+    DOUBLE,
+    STRING
+};
+
+// =============================================================================
+// PROFILE POLICIES
+// =============================================================================
+
+/**
+ * Host profile - numbers behave like JavaScript numbers (the reference implementation)
+ */
+struct HostProfile {
+    static constexpr TargetProfile id = TargetProfile::HOST;
+    static constexpr const char* name = "host";
+    static constexpr bool nativeIntegerMath = false;
+    static constexpr bool coerceQualifiedTypes = false;  // JS keeps "const int x = 2" as a number
+    static constexpr size_t ramSize = 1024 * 1024;       // No board limit; generous for arrays and malloc()
+    static constexpr size_t pointerSize = 4;
+    static constexpr size_t stackSize = 1024 * 1024;     // No board limit; the host evaluator stack bounds nesting
+    static constexpr size_t callFrameSize = 16;          // Return address and saved frame pointer
+    static constexpr int32_t ledBuiltin = 13;            // ASTInterpreter.js value
+
+    using Int = int32_t;
+    using UInt = uint32_t;
+    using Long = int32_t;
+    using ULong = uint32_t;
+    using Float = double;
+    using Double = double;
+
+    /**
+     * Only the primitive spellings the JavaScript interpreter coerces, plus
+     * char (not converted, only typed so a String appends it as a character)
+     */
+    static StaticType resolveType(const std::string& typeName) {
+        if (typeName == "int") return StaticType::INT;
+        if (typeName == "unsigned int") return StaticType::UNSIGNED_INT;
+        if (typeName == "byte") return StaticType::BYTE;
+        if (typeName == "char") return StaticType::CHAR;
+        if (typeName == "float") return StaticType::FLOAT;
+        if (typeName == "double") return StaticType::DOUBLE;
+        if (typeName == "bool") return StaticType::BOOL;
+        if (typeName == "String" || typeName == "char*") return StaticType::STRING;
+        return StaticType::UNKNOWN;
+    }
+};
+
+/**
+ * Full Arduino/C spelling table shared by the native profiles
+ */
+struct NativeTypeNames {
+    static StaticType resolveType(const std::string& typeName) {
+        if (typeName == "int" || typeName == "signed int") return StaticType::INT;
+        if (typeName == "unsigned int" || typeName == "unsigned" || typeName == "word" || typeName == "size_t") {
+            return StaticType::UNSIGNED_INT;
+        }
+        if (typeName == "long" || typeName == "long int" || typeName == "signed long") return StaticType::LONG;
+        if (typeName == "unsigned long" || typeName == "unsigned long int") return StaticType::UNSIGNED_LONG;
+        if (typeName == "short" || typeName == "int16_t") return StaticType::SHORT;
+        if (typeName == "unsigned short" || typeName == "uint16_t") return StaticType::UNSIGNED_SHORT;
+        if (typeName == "byte" || typeName == "uint8_t" || typeName == "unsigned char") return StaticType::BYTE;
+        if (typeName == "int8_t" || typeName == "signed char") return StaticType::INT8;
+        if (typeName == "char") return StaticType::CHAR;
+        if (typeName == "int32_t") return StaticType::INT32;
+        if (typeName == "uint32_t") return StaticType::UINT32;
+        if (typeName == "float") return StaticType::FLOAT;
+        if (typeName == "double") return StaticType::DOUBLE;
+        if (typeName == "bool" || typeName == "boolean") return StaticType::BOOL;
+        if (typeName == "String" || typeName == "char*") return StaticType::STRING;
+        return StaticType::UNKNOWN;
+    }
+};
+
+/**
+ * AVR 8-bit profile (ATmega328P/2560)
+ */
+struct Avr8Profile : NativeTypeNames {
+    static constexpr TargetProfile id = TargetProfile::AVR8;
+    static constexpr const char* name = "avr8";
+    static constexpr bool nativeIntegerMath = true;
+    static constexpr bool coerceQualifiedTypes = true;
+    static constexpr size_t ramSize = 2 * 1024;          // ATmega328P SRAM
+    static constexpr size_t pointerSize = 2;
+    static constexpr size_t stackSize = 1024;            // SRAM left to the stack beside globals and heap
+    static constexpr size_t callFrameSize = 4;           // Return address and saved frame pointer (Y)
+    static constexpr int32_t ledBuiltin = 13;            // Uno/Mega on-board LED (PB5/PB7)
+
+    using Int = int16_t;
+    using UInt = uint16_t;
+    using Long = int32_t;
+    using ULong = uint32_t;
+    using Float = float;
+    using Double = float;     // avr-gcc: double is an alias of float
+};
+
+/**
+ * ESP32 profile (Xtensa LX6/LX7)
+ */
+struct Esp32Profile : NativeTypeNames {
+    static constexpr TargetProfile id = TargetProfile::ESP32;
+    static constexpr const char* name = "esp32";
+    static constexpr bool nativeIntegerMath = true;
+    static constexpr bool coerceQualifiedTypes = true;
+    static constexpr size_t ramSize = 512 * 1024;        // ESP32-S3 internal SRAM
+    static constexpr size_t pointerSize = 4;
+    static constexpr size_t stackSize = 8 * 1024;        // Arduino loop task stack (CONFIG_ARDUINO_LOOP_STACK_SIZE)
+    static constexpr size_t callFrameSize = 32;          // call8 register window spill area
+    static constexpr int32_t ledBuiltin = 2;             // ESP32 DevKit on-board LED (GPIO2)
+
+    using Int = int32_t;
+    using UInt = uint32_t;
+    using Long = int32_t;
+    using ULong = uint32_t;
+    using Float = float;
+    using Double = double;
+};
+
+/**
+ * Profile name for diagnostics
+ */
+inline const char* targetProfileName(TargetProfile profile) {
+    switch (profile) {
+        case TargetProfile::AVR8: return Avr8Profile::name;
+        case TargetProfile::ESP32: return Esp32Profile::name;
+        default: return HostProfile::name;
+    }
+}
+
+/**
+ * SRAM of the profile's board, the default size of the simulated RAM
+ */
+inline size_t targetRamSize(TargetProfile profile) {
+    switch (profile) {
+        case TargetProfile::AVR8: return Avr8Profile::ramSize;
+        case TargetProfile::ESP32: return Esp32Profile::ramSize;
+        default: return HostProfile::ramSize;
+    }
+}
+
+/**
+ * Bytes of a data pointer on the profile's board
+ */
+inline size_t targetPointerSize(TargetProfile profile) {
+    switch (profile) {
+        case TargetProfile::AVR8: return Avr8Profile::pointerSize;
+        case TargetProfile::ESP32: return Esp32Profile::pointerSize;
+        default: return HostProfile::pointerSize;
+    }
+}
+
+/**
+ * Stack of the profile's board available to function call frames
+ */
+inline size_t targetStackSize(TargetProfile profile) {
+    switch (profile) {
+        case TargetProfile::AVR8: return Avr8Profile::stackSize;
+        case TargetProfile::ESP32: return Esp32Profile::stackSize;
+        default: return HostProfile::stackSize;
+    }
+}
+
+/**
+ * Fixed stack cost of one function call on the profile's board, before parameters
+ */
+inline size_t targetCallFrameSize(TargetProfile profile) {
+    switch (profile) {
+        case TargetProfile::AVR8: return Avr8Profile::callFrameSize;
+        case TargetProfile::ESP32: return Esp32Profile::callFrameSize;
+        default: return HostProfile::callFrameSize;
+    }
+}
+
+/**
+ * Pin of the board's built-in LED (LED_BUILTIN)
+ */
+inline int32_t targetLedBuiltin(TargetProfile profile) {
+    switch (profile) {
+        case TargetProfile::AVR8: return Avr8Profile::ledBuiltin;
+        case TargetProfile::ESP32: return Esp32Profile::ledBuiltin;
+        default: return HostProfile::ledBuiltin;
+    }
+}
+
+/**
+ * Parse profile name ("host", "avr8", "esp32"); unknown names select host
+ */
+inline TargetProfile parseTargetProfile(const std::string& name) {
+    if (name == Avr8Profile::name || name == "avr") return TargetProfile::AVR8;
+    if (name == Esp32Profile::name) return TargetProfile::ESP32;
+    return TargetProfile::HOST;
+}
+
+// =============================================================================
+// VALUE BOXING HELPERS
+// =============================================================================
+
+namespace target {
+
+/**
+ * Wrap an integer result to the width of T (two's complement / modulo 2^N)
+ * and box it. Unsigned 32-bit values above INT32_MAX do not fit the int
+ * payload of Value and are kept exact as double.
+ */
+template<typename T>
+inline Value wrapIntegral(int64_t value) {
+    static_assert(std::is_integral_v<T>, "wrapIntegral requires an integral type");
+    T narrowed = static_cast<T>(value);
+    if constexpr (std::is_unsigned_v<T> && sizeof(T) >= sizeof(int32_t)) {
+        if (narrowed > static_cast<T>(std::numeric_limits<int32_t>::max())) {
+            return static_cast<double>(narrowed);
+        }
+    }
+    return static_cast<int32_t>(narrowed);
+}
+
+/**
+ * Round a floating point result to the precision of T
+ */
+template<typename T>
+inline Value roundFloating(double value) {
+    static_assert(std::is_floating_point_v<T>, "roundFloating requires a floating point type");
+    return static_cast<double>(static_cast<T>(value));
+}
+
+/**
+ * Truncate a double toward zero the way a C cast does, saturating at the
+ * int64_t range so wrapIntegral always receives a defined value.
+ */
+inline int64_t truncateToInt64(double value) {
+    if (value != value) return 0;  // NaN
+    if (value >= 9.2233720368547758e18) return std::numeric_limits<int64_t>::max();
+    if (value <= -9.2233720368547758e18) return std::numeric_limits<int64_t>::min();
+    return static_cast<int64_t>(value);
+}
+
+/**
+ * Convert a double to a 32-bit int the way a C conversion through uint32_t
+ * does: truncate, then wrap modulo 2^32. An unsigned long above INT32_MAX,
+ * which wrapIntegral boxes as double, keeps its bit pattern (0xFFFFFFFFUL
+ * reads as -1) instead of hitting an out-of-range float-to-int cast.
+ */
+inline int32_t wrapToInt32(double value) {
+    return static_cast<int32_t>(static_cast<uint32_t>(truncateToInt64(value)));
+}
+
+/**
+ * Check whether an integer operand fits the profile's int; operands that do
+ * not are values of long type and the operation is carried out at long width
+ * (C usual arithmetic conversions).
+ */
+template<typename Profile>
+inline bool fitsInt(int64_t value) {
+    return value >= std::numeric_limits<typename Profile::Int>::min() &&
+           value <= std::numeric_limits<typename Profile::Int>::max();
+}
+
+// =============================================================================
+// EXPRESSION TYPES (C usual arithmetic conversions)
+// =============================================================================
+
+/**
+ * Width in bits of an integer static type on the profile, 0 for the others
+ */
+template<typename Profile>
+constexpr int integerBits(StaticType type) {
+    switch (type) {
+        case StaticType::BOOL:           return 1;
+        case StaticType::BYTE:
+        case StaticType::INT8:
+        case StaticType::CHAR:           return 8;
+        case StaticType::SHORT:
+        case StaticType::UNSIGNED_SHORT: return 16;
+        case StaticType::INT:
+        case StaticType::UNSIGNED_INT:   return static_cast<int>(sizeof(typename Profile::Int) * 8);
+        case StaticType::LONG:
+        case StaticType::UNSIGNED_LONG:  return static_cast<int>(sizeof(typename Profile::Long) * 8);
+        case StaticType::INT32:
+        case StaticType::UINT32:         return 32;
+        default:                         return 0;
+    }
+}
+
+constexpr bool isUnsignedType(StaticType type) {
+    return type == StaticType::BOOL || type == StaticType::BYTE || type == StaticType::UNSIGNED_SHORT ||
+           type == StaticType::UNSIGNED_INT || type == StaticType::UNSIGNED_LONG || type == StaticType::UINT32;
+}
+
+constexpr bool isFloatingType(StaticType type) {
+    return type == StaticType::FLOAT || type == StaticType::DOUBLE;
+}
+
+/**
+ * Integer promotion: types narrower than int become int (unsigned int when
+ * int cannot hold them), and int32_t/uint32_t become the int or long of the
+ * same width
+ */
+template<typename Profile>
+constexpr StaticType promote(StaticType type) {
+    constexpr int intBits = static_cast<int>(sizeof(typename Profile::Int) * 8);
+    int bits = integerBits<Profile>(type);
+    if (bits == 0) return type;
+    if (bits < intBits) return StaticType::INT;
+    if (type == StaticType::INT32) return bits == intBits ? StaticType::INT : StaticType::LONG;
+    if (type == StaticType::UINT32) return bits == intBits ? StaticType::UNSIGNED_INT : StaticType::UNSIGNED_LONG;
+    if (bits == intBits && (type == StaticType::SHORT || type == StaticType::UNSIGNED_SHORT)) {
+        return type == StaticType::SHORT ? StaticType::INT : StaticType::UNSIGNED_INT;
+    }
+    return type;
+}
+
+/**
+ * Type both operands of an arithmetic operator convert to. UNKNOWN when
+ * either side has no static type (or is a String).
+ */
+template<typename Profile>
+constexpr StaticType commonType(StaticType left, StaticType right) {
+    if (left == StaticType::UNKNOWN || right == StaticType::UNKNOWN ||
+        left == StaticType::STRING || right == StaticType::STRING) {
+        return StaticType::UNKNOWN;
+    }
+    if (left == StaticType::DOUBLE || right == StaticType::DOUBLE) return StaticType::DOUBLE;
+    if (left == StaticType::FLOAT || right == StaticType::FLOAT) return StaticType::FLOAT;
+
+    left = promote<Profile>(left);
+    right = promote<Profile>(right);
+    if (left == right) return left;
+
+    // After promotion only int, unsigned int, long and unsigned long remain
+    auto rank = [](StaticType type) { return type == StaticType::LONG || type == StaticType::UNSIGNED_LONG ? 2 : 1; };
+    bool leftUnsigned = isUnsignedType(left);
+    if (leftUnsigned == isUnsignedType(right)) return rank(left) >= rank(right) ? left : right;
+    StaticType unsignedSide = leftUnsigned ? left : right;
+    StaticType signedSide = leftUnsigned ? right : left;
+    if (rank(unsignedSide) >= rank(signedSide)) return unsignedSide;
+    if (integerBits<Profile>(signedSide) > integerBits<Profile>(unsignedSide)) return signedSide;
+    return signedSide == StaticType::LONG ? StaticType::UNSIGNED_LONG : StaticType::UNSIGNED_INT;
+}
+
+/**
+ * Type of a number constant: int when it fits, then long, then unsigned
+ * long; a constant with a decimal point or exponent is a double. Suffixes
+ * are not carried by the AST, so 0xFFFFFFFF is unsigned long on every
+ * profile and wider constants have no static type.
+ */
+template<typename Profile>
+inline StaticType literalType(double value, bool integer) {
+    if (!integer) return StaticType::DOUBLE;
+    if (value >= static_cast<double>(std::numeric_limits<typename Profile::Int>::min()) &&
+        value <= static_cast<double>(std::numeric_limits<typename Profile::Int>::max())) {
+        return StaticType::INT;
+    }
+    if (value >= static_cast<double>(std::numeric_limits<typename Profile::Long>::min()) &&
+        value <= static_cast<double>(std::numeric_limits<typename Profile::Long>::max())) {
+        return StaticType::LONG;
+    }
+    if (value >= 0 && value <= static_cast<double>(std::numeric_limits<typename Profile::ULong>::max())) {
+        return StaticType::UNSIGNED_LONG;
+    }
+    return StaticType::UNKNOWN;
+}
+
+} // namespace target
+
+} // namespace arduino_interpreter
@@ -0,0 +1,111 @@
+/**
+ * Value.cpp - Compact runtime value for interpreter storage
+ *
+ * Version: 1.0
+ */
+
+#include "Value.hpp"
+
+namespace arduino_interpreter {
+
+Value::Value(std::string value)
+    : kind_(Kind::STRING), string_(new StringRep{1, std::move(value)}) {}
+
+Value::Value(const CommandValue& value) : Value() {
+    switch (value.index()) {
+        case 1: kind_ = Kind::BOOL; bool_ = std::get<bool>(value); break;
+        case 2: kind_ = Kind::INT; int_ = std::get<int32_t>(value); break;
+        case 3: kind_ = Kind::DOUBLE; double_ = std::get<double>(value); break;
+        case 4: string_ = new StringRep{1, std::get<std::string>(value)}; kind_ = Kind::STRING; break;
+        default: break;
+    }
+}
+
+Value::Value(CommandValue&& value) : Value() {
+    if (auto* text = std::get_if<std::string>(&value)) {
+        string_ = new StringRep{1, std::move(*text)};
+        kind_ = Kind::STRING;
+    } else {
+        *this = Value(static_cast<const CommandValue&>(value));
+    }
+}
+
+Value::Value(const EnhancedCommandValue& value) : Value() {
+    switch (value.index()) {
+        case 0: break;
+        case 1: kind_ = Kind::BOOL; bool_ = std::get<bool>(value); break;
+        case 2: kind_ = Kind::INT; int_ = std::get<int32_t>(value); break;
+        case 3: kind_ = Kind::DOUBLE; double_ = std::get<double>(value); break;
+        case 4: string_ = new StringRep{1, std::get<std::string>(value)}; kind_ = Kind::STRING; break;
+        default: object_ = new ObjectRep{1, value}; kind_ = Kind::OBJECT; break;
+    }
+}
+
+CommandValue Value::toCommandValue() const {
+    switch (kind_) {
+        case Kind::BOOL: return bool_;
+        case Kind::INT: return int_;
+        case Kind::DOUBLE: return double_;
+        case Kind::STRING: return string_->text;
+        case Kind::OBJECT: return downgradeCommandValue(object_->object);
+        case Kind::VOID: break;
+    }
+    return std::monostate{};
+}
+
+FlexibleCommandValue Value::toFlexibleValue() const {
+    switch (kind_) {
+        case Kind::BOOL: return bool_;
+        case Kind::INT: return int_;
+        case Kind::DOUBLE: return double_;
+        case Kind::STRING: return string_->text;
+        case Kind::OBJECT: return convertCommandValue(downgradeCommandValue(object_->object));
+        case Kind::VOID: break;
+    }
+    return std::monostate{};
+}
+
+EnhancedCommandValue Value::toEnhancedValue() const {
+    switch (kind_) {
+        case Kind::BOOL: return bool_;
+        case Kind::INT: return int_;
+        case Kind::DOUBLE: return double_;
+        case Kind::STRING: return string_->text;
+        case Kind::OBJECT: return object_->object;
+        case Kind::VOID: break;
+    }
+    return std::monostate{};
+}
+
+std::string& Value::mutableString() {
+    if (string_->refs > 1) {
+        --string_->refs;
+        string_ = new StringRep{1, string_->text};
+    }
+    return string_->text;
+}
+
+bool Value::operator==(const Value& other) const {
+    if (kind_ != other.kind_) return false;
+    switch (kind_) {
+        case Kind::BOOL: return bool_ == other.bool_;
+        case Kind::INT: return int_ == other.int_;
+        case Kind::DOUBLE: return double_ == other.double_;
+        case Kind::STRING: return string_ == other.string_ || string_->text == other.string_->text;
+        case Kind::OBJECT: return object_ == other.object_ || object_->object == other.object_->object;
+        case Kind::VOID: break;
+    }
+    return true;
+}
+
+const Value& StringPool::intern(std::string_view text) {
+    auto found = strings_.find(text);
+    if (found != strings_.end()) {
+        return found->second;
+    }
+    Value pooled{std::string(text)};
+    std::string_view key = pooled.asString();
+    return strings_.emplace(key, std::move(pooled)).first->second;
+}
+
+} // namespace arduino_interpreter
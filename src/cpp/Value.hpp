@@ -0,0 +1,184 @@
+/**
+ * Value.hpp - Compact runtime value for interpreter storage
+ *
+ * CommandValue, EnhancedCommandValue and FlexibleCommandValue each carry a
+ * full std::string inline (40+ bytes per value), so every copy of a String
+ * variable allocates and every hand-over between the scope, data-model and
+ * command layers goes through a variant-to-variant conversion.
+ *
+ * Value is a 16-byte tagged union: bools, ints and doubles are stored inline,
+ * strings are reference-counted buffers shared between copies (and unshared
+ * before an in-place String update), and objects (structs, arrays, pointers,
+ * String objects) are reference-counted handles. Copying a Value never
+ * allocates, and the conversions to the other value families live here as
+ * one-step switches on the tag.
+ *
+ * Reference counts are not atomic: a Value belongs to the interpreter that
+ * created it. Hand values across threads as CommandValue.
+ *
+ * Version: 1.0
+ */
+
+#pragma once
+
+#include "CommandProtocol.hpp"
+#include "FlexibleCommand.hpp"
+#include "ArduinoDataTypes.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace arduino_interpreter {
+
+class Value {
+public:
+    enum class Kind : uint8_t {
+        VOID,
+        BOOL,
+        INT,
+        DOUBLE,
+        STRING,
+        OBJECT
+    };
+
+    Value() noexcept : kind_(Kind::VOID), bits_(0) {}
+    Value(std::monostate) noexcept : Value() {}
+    Value(bool value) noexcept : kind_(Kind::BOOL), bool_(value) {}
+    Value(int32_t value) noexcept : kind_(Kind::INT), int_(value) {}
+    Value(double value) noexcept : kind_(Kind::DOUBLE), double_(value) {}
+    Value(std::string value);
+    Value(const char* value) : Value(std::string(value)) {}
+    Value(const CommandValue& value);
+    Value(CommandValue&& value);
+    Value(const EnhancedCommandValue& value);
+
+    Value(const Value& other) noexcept : kind_(other.kind_), bits_(other.bits_) { retain(); }
+    Value(Value&& other) noexcept : kind_(other.kind_), bits_(other.bits_) { other.kind_ = Kind::VOID; }
+    ~Value() { release(); }
+
+    Value& operator=(const Value& other) noexcept {
+        if (this != &other) {
+            other.retain();
+            release();
+            kind_ = other.kind_;
+            bits_ = other.bits_;
+        }
+        return *this;
+    }
+
+    Value& operator=(Value&& other) noexcept {
+        if (this != &other) {
+            release();
+            kind_ = other.kind_;
+            bits_ = other.bits_;
+            other.kind_ = Kind::VOID;
+        }
+        return *this;
+    }
+
+    Kind kind() const { return kind_; }
+    bool isVoid() const { return kind_ == Kind::VOID; }
+    bool isBool() const { return kind_ == Kind::BOOL; }
+    bool isInt() const { return kind_ == Kind::INT; }
+    bool isDouble() const { return kind_ == Kind::DOUBLE; }
+    bool isString() const { return kind_ == Kind::STRING; }
+    bool isObject() const { return kind_ == Kind::OBJECT; }
+
+    /** Unchecked payload access; check kind() first */
+    bool asBool() const { return bool_; }
+    int32_t asInt() const { return int_; }
+    double asDouble() const { return double_; }
+    const std::string& asString() const { return string_->text; }
+    const EnhancedCommandValue& asObject() const { return object_->object; }
+
+    /** Writable string payload, unshared first if other values hold it; check isString() first */
+    std::string& mutableString();
+
+    /**
+     * Call fn with the payload as one of std::monostate, bool, int32_t, double
+     * or const std::string& (the CommandValue alternatives). Objects are
+     * passed as std::monostate; check isObject() first where they matter.
+     */
+    template<typename Fn>
+    decltype(auto) visit(Fn&& fn) const {
+        switch (kind_) {
+            case Kind::BOOL: return fn(bool_);
+            case Kind::INT: return fn(int_);
+            case Kind::DOUBLE: return fn(double_);
+            case Kind::STRING: return fn(static_cast<const std::string&>(string_->text));
+            case Kind::VOID:
+            case Kind::OBJECT: break;
+        }
+        return fn(std::monostate{});
+    }
+
+    // Conversions to the command and data-model value families (objects
+    // become their string form outside the data model)
+    CommandValue toCommandValue() const;
+    FlexibleCommandValue toFlexibleValue() const;
+    EnhancedCommandValue toEnhancedValue() const;
+
+    /** Same kind and payload (strings compare by content) */
+    bool operator==(const Value& other) const;
+    bool operator!=(const Value& other) const { return !(*this == other); }
+
+private:
+    struct StringRep {
+        uint32_t refs;
+        std::string text;
+    };
+
+    struct ObjectRep {
+        uint32_t refs;
+        EnhancedCommandValue object;
+    };
+
+    void retain() const noexcept {
+        if (kind_ == Kind::STRING) ++string_->refs;
+        else if (kind_ == Kind::OBJECT) ++object_->refs;
+    }
+
+    void release() noexcept {
+        if (kind_ == Kind::STRING && --string_->refs == 0) delete string_;
+        else if (kind_ == Kind::OBJECT && --object_->refs == 0) delete object_;
+    }
+
+    Kind kind_;
+    union {
+        bool bool_;
+        int32_t int_;
+        double double_;
+        StringRep* string_;
+        ObjectRep* object_;
+        uint64_t bits_;     // Whole payload, for copies
+    };
+};
+
+static_assert(sizeof(Value) == 16, "Value must stay a 16-byte tagged union");
+
+/**
+ * Interned string literals
+ *
+ * Each distinct text is stored once, in a Value the pool keeps a reference
+ * to. Copies handed out share that buffer, so an in-place String update on a
+ * copy always unshares first: pooled text is immutable for the pool's lifetime.
+ */
+class StringPool {
+public:
+    /** The pooled Value for text, added on first use */
+    const Value& intern(std::string_view text);
+    
+    size_t size() const { return strings_.size(); }
+    void clear() { strings_.clear(); }
+    
+private:
+    // Keys view the pooled buffers themselves
+    std::unordered_map<std::string_view, Value> strings_;
+};
+
+inline std::string valueToString(const Value& value) {
+    return commandValueToString(value.toCommandValue());
+}
+
+} // namespace arduino_interpreter
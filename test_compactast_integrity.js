@@ -87,13 +87,19 @@ function getNamedChildProperties(node) {
         'ExpressionStatement': ['expression'],
         'MemberAccessNode': ['object', 'property'],
         'ParamNode': ['paramType', 'declarator', 'defaultValue'],
-        'ArrayAccessNode': ['object', 'index'],
+        'ArrayAccessNode': ['identifier', 'index'],
+        'ArrayDeclaratorNode': ['identifier', 'dimensions'],
+        'ArrayInitializerNode': ['elements'],
         'SwitchStatement': ['discriminant', 'cases'], 
         'CaseStatement': ['test', 'consequent'],
-        'RangeBasedForStatement': ['variable', 'iterable', 'body'],
+        'RangeBasedForStatement': ['declaration', 'range', 'body'],
         'TernaryExpression': ['condition', 'consequent', 'alternate'],
         'PostfixExpressionNode': ['operand'],
-        'CommaExpression': ['left', 'right']
+        'CommaExpression': ['left', 'right'],
+        'StructDeclaration': ['members'],
+        'StructMember': ['memberType', 'declarator'],
+        'MultipleStructMembers': ['memberType', 'declarations'],
+        'TypedefDeclaration': ['baseType']
     };
     
     return childrenMap[node.type] || [];
@@ -0,0 +1,122 @@
+/**
+ * benchmark_interpreter_farm.cpp - InterpreterFarm Worker Scaling Benchmark
+ *
+ * Usage: ./benchmark_interpreter_farm [test_number] [instances] [loop_iterations]
+ * Example: ./benchmark_interpreter_farm 0 256 200
+ *
+ * Runs many copies of one test sketch (async mode, sensor reads answered by a
+ * simulated responder, delays on the virtual clock) with 1, 2, 4, ... worker
+ * threads up to the hardware concurrency, and reports loop() iterations per
+ * second for each worker count.
+ */
+
+#include "test_utils.hpp"
+#include "../src/cpp/InterpreterFarm.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+
+using namespace arduino_interpreter;
+using namespace arduino_interpreter::testing;
+
+namespace {
+
+struct RunResult {
+    double seconds;
+    InterpreterFarm::FarmStats stats;
+};
+
+RunResult runFarm(const std::vector<uint8_t>& compactAST, size_t instances, uint32_t loopIterations, size_t workers) {
+    FarmOptions farmOptions;
+    farmOptions.workerCount = workers;
+
+    InterpreterFarm farm(farmOptions);
+    farm.setCommandSink([](const std::vector<FarmCommand>&) {});
+    farm.setRequestResponder([&farm](FarmInstanceId id, const TypedCommand& request, CommandValue& value) {
+        const std::string& type = request.getType();
+        if (type == "MILLIS_REQUEST") {
+            value = static_cast<int32_t>(farm.getVirtualTimeMicros() / 1000);
+        } else if (type == "MICROS_REQUEST") {
+            value = static_cast<int32_t>(farm.getVirtualTimeMicros());
+        } else if (type == "DIGITAL_READ_REQUEST") {
+            value = static_cast<int32_t>(id & 1);
+        } else {
+            value = static_cast<int32_t>((id * 37) % 1024);
+        }
+        return true;
+    });
+
+    InterpreterOptions options;
+    options.verbose = false;
+    options.debug = false;
+    options.maxLoopIterations = loopIterations;
+    options.syncMode = false;
+
+    for (size_t i = 0; i < instances; ++i) {
+        farm.addInstance(std::make_unique<ASTInterpreter>(compactAST.data(), compactAST.size(), options));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    farm.start();
+    farm.wait();
+    farm.stop();
+    auto endTime = std::chrono::steady_clock::now();
+
+    return RunResult{std::chrono::duration<double>(endTime - startTime).count(), farm.getStats()};
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    int testNumber = argc > 1 ? std::atoi(argv[1]) : 0;
+    size_t instances = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 256;
+    uint32_t loopIterations = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 200;
+
+    std::ostringstream astFileName;
+    astFileName << "../test_data/example_" << std::setfill('0') << std::setw(3) << testNumber << ".ast";
+
+    std::vector<uint8_t> compactAST;
+    if (!loadAST(astFileName.str(), compactAST)) {
+        std::cerr << "ERROR: Cannot open " << astFileName.str() << std::endl;
+        return 1;
+    }
+
+    size_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "=== INTERPRETER FARM BENCHMARK ===" << std::endl;
+    std::cout << "AST File: " << astFileName.str() << std::endl;
+    std::cout << "Instances: " << instances << ", loop iterations: " << loopIterations
+              << ", hardware threads: " << maxWorkers << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(8) << "workers" << std::setw(12) << "seconds" << std::setw(16) << "loops/sec"
+              << std::setw(10) << "speedup" << std::setw(10) << "steals" << std::setw(10) << "parks" << std::endl;
+
+    double baseline = 0.0;
+    for (size_t workers = 1; ; workers = std::min(workers * 2, maxWorkers)) {
+        RunResult result = runFarm(compactAST, instances, loopIterations, workers);
+        double rate = result.stats.loopIterations / result.seconds;
+        if (baseline == 0.0) {
+            baseline = rate;
+        }
+
+        std::cout << std::setw(8) << workers
+                  << std::setw(12) << std::fixed << std::setprecision(3) << result.seconds
+                  << std::setw(16) << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << rate / baseline << "x"
+                  << std::setw(10) << result.stats.steals
+                  << std::setw(10) << result.stats.parks << std::endl;
+
+        if (result.stats.instancesCompleted != instances) {
+            std::cerr << "ERROR: only " << result.stats.instancesCompleted << " of " << instances
+                      << " instances completed" << std::endl;
+            return 1;
+        }
+        if (workers == maxWorkers) {
+            break;
+        }
+    }
+
+    return 0;
+}
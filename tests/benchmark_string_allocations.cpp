@@ -0,0 +1,149 @@
+/**
+ * benchmark_string_allocations.cpp - Heap Allocations on String-Heavy Sketches
+ *
+ * Usage: ./benchmark_string_allocations [loop_iterations] [test_number...]
+ * Example: ./benchmark_string_allocations 100 46 47 54
+ *
+ * Runs each test sketch (by default the 08.Strings examples, 46-57) in sync
+ * mode and counts every global operator new made while the interpreter runs,
+ * including the command stream. Interpreter construction (AST parsing and
+ * load-time analysis) is excluded. Reports allocations and bytes per run and
+ * per loop() iteration.
+ */
+
+#include "test_utils.hpp"
+#include "../src/cpp/ExecutionTracer.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <new>
+
+using namespace arduino_interpreter;
+using namespace arduino_interpreter::testing;
+
+namespace {
+
+bool countingEnabled = false;
+size_t allocationCount = 0;
+size_t allocatedBytes = 0;
+
+void* countedAllocate(std::size_t size) {
+    if (countingEnabled) {
+        ++allocationCount;
+        allocatedBytes += size;
+    }
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+/** Discards commands; counts them so the stream is still produced */
+class CountingListener : public FlexibleCommandListener {
+public:
+    size_t commands = 0;
+    void onTypedCommand(const TypedCommand&) override { ++commands; }
+    void onCommand(const FlexibleCommand&) override {}
+    void onError(const std::string&) override {}
+};
+
+struct RunResult {
+    size_t allocations;
+    size_t bytes;
+    size_t commands;
+    uint32_t loops;
+};
+
+bool loadAST(int testNumber, std::vector<uint8_t>& compactAST) {
+    std::ostringstream astFileName;
+    astFileName << "../test_data/example_" << std::setfill('0') << std::setw(3) << testNumber << ".ast";
+    std::ifstream file(astFileName.str(), std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "ERROR: Cannot open " << astFileName.str() << std::endl;
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    compactAST.resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(compactAST.data()), size);
+    return true;
+}
+
+RunResult runSketch(const std::vector<uint8_t>& compactAST, uint32_t loopIterations) {
+    InterpreterOptions options;
+    options.verbose = false;
+    options.debug = false;
+    options.maxLoopIterations = loopIterations;
+    options.syncMode = true;
+
+    ASTInterpreter interpreter(compactAST.data(), compactAST.size(), options);
+    CountingListener listener;
+    MockResponseHandler responder;
+    interpreter.setCommandListener(&listener);
+    interpreter.setResponseHandler(&responder);
+
+    allocationCount = 0;
+    allocatedBytes = 0;
+    countingEnabled = true;
+    interpreter.start();
+    countingEnabled = false;
+
+    return RunResult{allocationCount, allocatedBytes, listener.commands,
+                     interpreter.getLoopIteration()};
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+
+int main(int argc, char* argv[]) {
+    uint32_t loopIterations = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100;
+    std::vector<int> tests;
+    for (int i = 2; i < argc; ++i) {
+        tests.push_back(std::atoi(argv[i]));
+    }
+    if (tests.empty()) {
+        for (int test = 46; test <= 57; ++test) {
+            tests.push_back(test);
+        }
+    }
+
+    g_tracer.disable();
+
+    std::cout << "=== STRING ALLOCATION BENCHMARK ===" << std::endl;
+    std::cout << "Loop iterations: " << loopIterations << std::endl;
+    std::cout << std::endl;
+    std::cout << std::setw(6) << "test" << std::setw(8) << "loops" << std::setw(12) << "allocs"
+              << std::setw(14) << "bytes" << std::setw(10) << "commands" << std::setw(14) << "allocs/loop"
+              << std::setw(14) << "bytes/loop" << std::endl;
+
+    size_t totalAllocations = 0;
+    size_t totalBytes = 0;
+    for (int test : tests) {
+        std::vector<uint8_t> compactAST;
+        if (!loadAST(test, compactAST)) {
+            return 1;
+        }
+        RunResult result = runSketch(compactAST, loopIterations);
+        double loops = std::max<uint32_t>(result.loops, 1);
+        totalAllocations += result.allocations;
+        totalBytes += result.bytes;
+
+        std::cout << std::setw(6) << test << std::setw(8) << result.loops
+                  << std::setw(12) << result.allocations << std::setw(14) << result.bytes
+                  << std::setw(10) << result.commands
+                  << std::setw(14) << std::fixed << std::setprecision(1) << result.allocations / loops
+                  << std::setw(14) << result.bytes / loops << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "Total: " << totalAllocations << " allocations, " << totalBytes << " bytes" << std::endl;
+    return 0;
+}
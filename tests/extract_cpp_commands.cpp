@@ -68,6 +68,7 @@ int main(int argc, char* argv[]) {
         options.debug = false;
         options.maxLoopIterations = 1; // MATCH JAVASCRIPT: Use exactly 1 iteration like JS test data
         options.syncMode = true; // TEST MODE: Enable synchronous responses for digitalRead/analogRead
+        options.traceSwitchCases = true; // MATCH JAVASCRIPT: Report the cases tested before the match
         
         auto interpreter = std::make_unique<ASTInterpreter>(compactAST.data(), compactAST.size(), options);
         interpreter->setCommandListener(&capture);
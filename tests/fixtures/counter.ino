@@ -0,0 +1,12 @@
+// Counter: the global changes on every loop() pass, so no two passes match
+int count = 0;
+
+void setup() {
+  pinMode(9, OUTPUT);
+}
+
+void loop() {
+  count++;
+  analogWrite(9, count);
+  delay(10);
+}
@@ -0,0 +1,16 @@
+// Recursion far deeper than any evaluator stack: must end in a StackOverflowError
+long depth = 0;
+
+void descend() {
+  if (depth < 1000000) {
+    depth = depth + 1;
+    descend();
+  }
+}
+
+void setup() {
+  descend();
+}
+
+void loop() {
+}
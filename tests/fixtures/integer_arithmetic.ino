@@ -0,0 +1,23 @@
+// Arithmetic in the operands' C types, stored at the declared type
+int quotient = 0;
+int wrapped = 0;
+unsigned long now = 0;
+unsigned long elapsed = 0;
+float third = 0;
+
+void setup() {
+  quotient = 7 / 2;
+
+  int largest = 32767;
+  wrapped = largest + 1;
+
+  // millis() one tick before it wraps around
+  unsigned long start = 4294967295;
+  now = start + 1;
+  elapsed = now - start;
+
+  third = 1.0 / 3;
+}
+
+void loop() {
+}
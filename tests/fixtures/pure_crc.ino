@@ -0,0 +1,35 @@
+// Pure user functions: a loop-based CRC-8, called again with the same data
+// and from another pure function
+int first = 0;
+int again = 0;
+int other = 0;
+int mixed = 0;
+
+uint8_t crc8(uint32_t value) {
+  uint8_t crc = 0;
+  for (int i = 0; i < 4; i++) {
+    crc ^= (value >> (8 * i)) & 0xFF;
+    for (int bit = 0; bit < 8; bit++) {
+      if (crc & 0x80) {
+        crc = (crc << 1) ^ 0x07;
+      } else {
+        crc = crc << 1;
+      }
+    }
+  }
+  return crc;
+}
+
+int checksum(uint32_t a, uint32_t b) {
+  return crc8(a) ^ crc8(b);
+}
+
+void setup() {
+  first = crc8(305419896);
+  again = crc8(305419896);
+  other = crc8(42);
+  mixed = checksum(305419896, 42);
+}
+
+void loop() {
+}
@@ -0,0 +1,11 @@
+// Sensor: every loop() pass waits for an analogRead() answer from the host
+int level = 0;
+
+void setup() {
+  pinMode(9, OUTPUT);
+}
+
+void loop() {
+  level = analogRead(0);
+  analogWrite(9, level / 4);
+}
@@ -0,0 +1,24 @@
+// String formatting: floats with two decimals, integral literals as ints,
+// char variables as characters, untyped String operands still concatenate
+String fromFloat = "";
+String fromLiteral = "";
+String appended = "";
+String joined = "";
+String piece = "";
+String label = "abc";
+
+void setup() {
+  char grade = 'A';
+  float ratio = 0.25;
+  fromFloat = String(1.5);
+  fromLiteral = String(42);
+  appended = "n=";
+  appended += 5;
+  appended += grade;
+  appended += ratio;
+  joined = "x" + String(7) + grade;
+  piece = label.substring(1) + 1;
+}
+
+void loop() {
+}
@@ -0,0 +1,27 @@
+// Switch dispatch: matched case, fall-through into the next case, default
+int picked = 0;
+int fallen = 0;
+int other = 0;
+
+void setup() {
+  int mode = 3;
+  switch (mode) {
+    case 1: picked = 10; break;
+    case 2: picked = 20; break;
+    case 3: picked = 30; break;
+    case 4: picked = 40; break;
+  }
+  switch (2) {
+    case 1: fallen = fallen + 1;
+    case 2: fallen = fallen + 2;
+    case 3: fallen = fallen + 4; break;
+    case 4: fallen = fallen + 8;
+  }
+  switch (9) {
+    case 1: other = 1; break;
+    default: other = -1; break;
+  }
+}
+
+void loop() {
+}
@@ -0,0 +1,20 @@
+// User function calls: results used in expressions, default arguments, arity
+int total = 0;
+int scaled = 0;
+
+int add(int a, int b) {
+  return a + b;
+}
+
+int scale(int x, int factor = 3) {
+  return x * factor;
+}
+
+void setup() {
+  total = add(2, 3) * 2;
+  scaled = scale(4);
+  add(1, 2, 3);
+}
+
+void loop() {
+}
@@ -0,0 +1,166 @@
+/**
+ * test_call_allocations.cpp - Heap allocations of the function call path
+ *
+ * Counts every global operator new while call arguments are built and while
+ * Blink (example_002) runs loop() in sync mode. Argument lists and the tick
+ * arena must not touch the heap once warm, and a steady-state loop() pass,
+ * typed commands included, must not allocate at all for a listener that
+ * consumes TypedCommand directly.
+ */
+
+#include "test_utils.hpp"
+#include "../src/cpp/CallArguments.hpp"
+#include "../src/cpp/ExecutionTracer.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "../test_data"
+#endif
+
+using namespace arduino_interpreter;
+using namespace arduino_interpreter::testing;
+
+namespace {
+
+bool countingEnabled = false;
+size_t allocationCount = 0;
+
+void* countedAllocate(std::size_t size) {
+    if (countingEnabled) {
+        ++allocationCount;
+    }
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void startCounting() {
+    allocationCount = 0;
+    countingEnabled = true;
+}
+
+size_t stopCounting() {
+    countingEnabled = false;
+    return allocationCount;
+}
+
+/** Allocations between consecutive loop() passes */
+class IterationListener : public FlexibleCommandListener {
+public:
+    uint32_t iterations = 0;
+    uint32_t firstMeasured = 0;
+    std::vector<size_t> allocationsPerIteration;
+
+    void onTypedCommand(const TypedCommand& command) override {
+        if (command.kind() != TypedCommand::Kind::LOOP_START) return;
+        iterations++;
+        if (iterations > firstMeasured) {
+            allocationsPerIteration.push_back(stopCounting());
+        }
+        if (iterations >= firstMeasured) {
+            startCounting();
+        }
+    }
+    void onCommand(const FlexibleCommand&) override {}
+    void onError(const std::string&) override {}
+};
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+
+// =============================================================================
+// ARGUMENT LISTS
+// =============================================================================
+
+void testInlineArguments() {
+    startCounting();
+    {
+        CallArguments args;
+        for (size_t i = 0; i < CallArguments::INLINE_CAPACITY; ++i) {
+            args.push_back(static_cast<int32_t>(i));
+        }
+        TEST_ASSERT_EQ(args.size(), CallArguments::INLINE_CAPACITY, "argument count");
+        TEST_ASSERT(std::get<int32_t>(args[5]) == 5, "last inline argument");
+    }
+    TEST_ASSERT_EQ(stopCounting(), 0u, "allocations of an inline argument list");
+}
+
+void testArenaArguments() {
+    TickArena arena;
+    const size_t count = CallArguments::INLINE_CAPACITY * 4;
+
+    for (int tick = 0; tick < 3; ++tick) {
+        startCounting();
+        {
+            CallArguments args(&arena);
+            for (size_t i = 0; i < count; ++i) {
+                args.push_back(static_cast<double>(i));
+            }
+            TEST_ASSERT(std::get<double>(args[count - 1]) == static_cast<double>(count - 1), "spilled argument");
+        }
+        size_t allocations = stopCounting();
+        arena.reset();
+        if (tick > 0) {
+            TEST_ASSERT_EQ(allocations, 0u, "allocations of a spilled argument list in a warm arena");
+        }
+    }
+}
+
+// =============================================================================
+// STEADY-STATE LOOP
+// =============================================================================
+
+void testBlinkSteadyState() {
+    std::vector<uint8_t> compactAST;
+    TEST_ASSERT(loadAST(TEST_DATA_DIR "/example_002.ast", compactAST), "cannot open example_002.ast");
+
+    InterpreterOptions options;
+    options.maxLoopIterations = 40;
+    options.syncMode = true;
+    ASTInterpreter interpreter(compactAST.data(), compactAST.size(), options);
+    IterationListener listener;
+    listener.firstMeasured = 10;  // setup() and the first passes resolve names and size buffers
+    MockResponseHandler responder;
+    interpreter.setCommandListener(&listener);
+    interpreter.setResponseHandler(&responder);
+    interpreter.start();
+    stopCounting();
+
+    TEST_ASSERT(listener.allocationsPerIteration.size() >= 20, "too few loop() passes measured");
+    for (size_t allocations : listener.allocationsPerIteration) {
+        TEST_ASSERT_EQ(allocations, 0u, "allocations of a steady-state loop() pass");
+    }
+}
+
+// =============================================================================
+// MAIN TEST RUNNER
+// =============================================================================
+
+int main() {
+    std::cout << "=== Call Path Allocation Tests ===" << std::endl;
+    g_tracer.disable();
+
+    int passed = 0;
+    int failed = 0;
+
+    auto result1 = runTest("Inline Arguments", testInlineArguments);
+    if (result1.success) passed++; else failed++;
+
+    auto result2 = runTest("Arena Arguments", testArenaArguments);
+    if (result2.success) passed++; else failed++;
+
+    auto result3 = runTest("Blink Steady State", testBlinkSteadyState);
+    if (result3.success) passed++; else failed++;
+
+    std::cout << std::endl;
+    std::cout << "Passed: " << passed << ", Failed: " << failed << std::endl;
+    return failed == 0 ? 0 : 1;
+}
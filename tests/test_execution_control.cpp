@@ -0,0 +1,239 @@
+/**
+ * test_execution_control.cpp - How the interpreter runs loop() passes
+ *
+ * Drives sketches to completion with start() and with budgeted slices
+ * (tickFor/tickSteps) and checks that both paths emit the same commands, and
+ * that a slice stops where its budget, the program or a request ends it. Fixtures are
+ * tests/fixtures/<name>.ast, exported from the .ino next to them with the
+ * JavaScript parser (exportCompactAST).
+ */
+
+#include "test_utils.hpp"
+#include "../src/cpp/ExecutionTracer.hpp"
+
+#ifndef TEST_FIXTURE_DIR
+#define TEST_FIXTURE_DIR "../tests/fixtures"
+#endif
+
+using namespace arduino_interpreter;
+using namespace arduino_interpreter::testing;
+
+namespace {
+
+/** Type of every command, in order, and the id of the last request */
+class CommandTypeRecorder : public FlexibleCommandListener {
+public:
+    std::vector<std::string> types;
+    std::string lastRequestId;
+    FlexibleCommandValue lastValueSet;
+
+    void onCommand(const FlexibleCommand& command) override {
+        types.push_back(command.getType());
+        if (command.has("requestId")) {
+            FlexibleCommandValue requestId = command.get("requestId");
+            if (const auto* text = std::get_if<std::string>(&requestId)) lastRequestId = *text;
+        } else if (command.getType() == "VAR_SET") {
+            lastValueSet = command.get("value");
+        }
+    }
+    void onError(const std::string& error) override { types.push_back("ERROR " + error); }
+};
+
+struct SketchRun {
+    std::vector<std::string> commandTypes;
+    uint32_t fastForwardedIterations = 0;
+    uint32_t steadyStateMismatches = 0;
+    uint32_t loopIterations = 0;
+};
+
+InterpreterOptions loopOptions(uint32_t iterations, bool fastForward) {
+    InterpreterOptions options;
+    options.maxLoopIterations = iterations;
+    options.syncMode = true;
+    options.steadyStateFastForward = fastForward;
+    return options;
+}
+
+/** Run a fixture with start(), or with tickSteps(sliceSteps) slices when sliceSteps is set */
+SketchRun runSketch(const std::string& name, InterpreterOptions options, uint64_t sliceSteps = 0) {
+    SketchRun run;
+    std::vector<uint8_t> compactAST;
+    TEST_ASSERT(loadAST(std::string(TEST_FIXTURE_DIR) + "/" + name + ".ast", compactAST), "cannot open " + name + ".ast");
+
+    options.syncMode = sliceSteps == 0;
+    ASTInterpreter interpreter(compactAST.data(), compactAST.size(), options);
+    CommandTypeRecorder recorder;
+    MockResponseHandler responder;
+    interpreter.setCommandListener(&recorder);
+    interpreter.setResponseHandler(&responder);
+
+    if (sliceSteps == 0) {
+        interpreter.start();
+    } else {
+        while (interpreter.tickSteps(sliceSteps)) {
+        }
+    }
+
+    run.commandTypes = recorder.types;
+    run.fastForwardedIterations = interpreter.getFastForwardedIterations();
+    run.steadyStateMismatches = interpreter.getSteadyStateMismatches();
+    run.loopIterations = interpreter.getLoopIteration();
+    return run;
+}
+
+/** Interpreter of a fixture, driven by the test one slice at a time */
+struct SlicedSketch {
+    std::vector<uint8_t> compactAST;
+    CommandTypeRecorder recorder;
+    MockResponseHandler responder;
+    std::unique_ptr<ASTInterpreter> interpreter;
+
+    SlicedSketch(const std::string& name, uint32_t iterations) {
+        TEST_ASSERT(loadAST(std::string(TEST_FIXTURE_DIR) + "/" + name + ".ast", compactAST), "cannot open " + name + ".ast");
+        InterpreterOptions options = loopOptions(iterations, false);
+        options.syncMode = false;
+        interpreter = std::make_unique<ASTInterpreter>(compactAST.data(), compactAST.size(), options);
+        interpreter->setCommandListener(&recorder);
+        interpreter->setResponseHandler(&responder);
+    }
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// STEADY-STATE DETECTION
+// =============================================================================
+
+void testBlinkIsFastForwarded() {
+    SketchRun executed = runSketch("blink", loopOptions(40, false));
+    TEST_ASSERT_EQ(executed.loopIterations, 40u, "plain run completes every iteration");
+    TEST_ASSERT_EQ(executed.fastForwardedIterations, 0u, "nothing is replayed without fast-forward");
+
+    // Whole run and sliced run share the iteration path, so both lock onto the cycle
+    SketchRun replayed = runSketch("blink", loopOptions(40, true));
+    SketchRun sliced = runSketch("blink", loopOptions(40, true), 3);
+    TEST_ASSERT(replayed.fastForwardedIterations > 0, "Blink settles into a replayable cycle");
+    TEST_ASSERT(sliced.fastForwardedIterations > 0, "Blink is replayed when run in slices");
+    TEST_ASSERT(replayed.commandTypes == executed.commandTypes, "replay emits the commands execution would");
+    TEST_ASSERT(sliced.commandTypes == executed.commandTypes, "sliced replay emits the commands execution would");
+
+    InterpreterOptions verify = loopOptions(40, true);
+    verify.steadyStateVerify = true;
+    SketchRun verified = runSketch("blink", verify);
+    TEST_ASSERT_EQ(verified.steadyStateMismatches, 0u, "every locked Blink cycle matches its template");
+}
+
+void testChangingStateIsNotFastForwarded() {
+    SketchRun executed = runSketch("counter", loopOptions(40, false));
+    SketchRun whole = runSketch("counter", loopOptions(40, true));
+    SketchRun sliced = runSketch("counter", loopOptions(40, true), 3);
+
+    TEST_ASSERT_EQ(whole.fastForwardedIterations, 0u, "a counter that keeps changing never locks");
+    TEST_ASSERT_EQ(sliced.fastForwardedIterations, 0u, "nor when run in slices");
+    TEST_ASSERT_EQ(whole.loopIterations, 40u, "every iteration is executed");
+    TEST_ASSERT(whole.commandTypes == executed.commandTypes, "detection alone does not change the commands");
+}
+
+// =============================================================================
+// BUDGETED TICKS
+// =============================================================================
+
+void testSliceStopsWhenBudgetIsSpent() {
+    SketchRun executed = runSketch("blink", loopOptions(20, false));
+
+    // One preemption point per slice: the program is parked long before its last iteration
+    SlicedSketch stepped("blink", 20);
+    TEST_ASSERT(stepped.interpreter->tickSteps(1), "a one-step slice leaves work to do");
+    TEST_ASSERT(stepped.interpreter->isRunning(), "a preempted program is still running");
+    TEST_ASSERT(stepped.interpreter->getLoopIteration() < 20, "a one-step slice does not finish the program");
+    size_t slices = 1;
+    while (stepped.interpreter->tickSteps(1)) {
+        slices++;
+    }
+    TEST_ASSERT(slices > 20, "every loop() pass takes at least one slice");
+    TEST_ASSERT(stepped.recorder.types == executed.commandTypes, "preempted slices emit the commands of one whole run");
+
+    // An empty time budget runs to the first preemption point only
+    SlicedSketch timed("blink", 20);
+    TEST_ASSERT(timed.interpreter->tickFor(std::chrono::microseconds(0)), "a spent time budget leaves work to do");
+    TEST_ASSERT(timed.interpreter->getLoopIteration() < 20, "a spent time budget does not finish the program");
+    while (timed.interpreter->tickFor(std::chrono::microseconds(0))) {
+    }
+    TEST_ASSERT(timed.recorder.types == executed.commandTypes, "timed slices emit the commands of one whole run");
+}
+
+void testSliceReportsCompletion() {
+    SketchRun executed = runSketch("blink", loopOptions(20, false));
+
+    SlicedSketch stepped("blink", 20);
+    TEST_ASSERT(!stepped.interpreter->tickSteps(1000000), "a slice large enough for the program reports no more work");
+    TEST_ASSERT(!stepped.interpreter->isRunning(), "the program has completed");
+    TEST_ASSERT_EQ(stepped.interpreter->getLoopIteration(), 20u, "every iteration ran in the one slice");
+    TEST_ASSERT(stepped.recorder.types == executed.commandTypes, "one slice emits the commands of one whole run");
+
+    size_t emitted = stepped.recorder.types.size();
+    TEST_ASSERT(!stepped.interpreter->tickSteps(1000000), "a completed program stays completed");
+    TEST_ASSERT_EQ(stepped.recorder.types.size(), emitted, "a completed program emits nothing more");
+
+    SlicedSketch timed("blink", 20);
+    TEST_ASSERT(!timed.interpreter->tickFor(std::chrono::seconds(10)), "a generous time budget completes the program");
+    TEST_ASSERT_EQ(timed.interpreter->getLoopIteration(), 20u, "every iteration ran in the timed slice");
+}
+
+void testSliceWaitsOnRequest() {
+    SlicedSketch sketch("sensor", 3);
+
+    for (int32_t reading : {400, 800, 120}) {
+        TEST_ASSERT(sketch.interpreter->tickSteps(1000000), "a program parked on analogRead() has more work");
+        TEST_ASSERT(sketch.interpreter->isWaitingForResponse(), "the slice ends at the request");
+        TEST_ASSERT(!sketch.recorder.lastRequestId.empty(), "the request carries an id to answer");
+
+        // No answer yet: further slices leave the program where it is
+        size_t emitted = sketch.recorder.types.size();
+        TEST_ASSERT(sketch.interpreter->tickFor(std::chrono::milliseconds(1)), "an unanswered request keeps the program waiting");
+        TEST_ASSERT_EQ(sketch.recorder.types.size(), emitted, "nothing runs while the request is unanswered");
+
+        sketch.interpreter->handleResponse(sketch.recorder.lastRequestId, reading);
+        sketch.recorder.lastRequestId.clear();
+        TEST_ASSERT(sketch.interpreter->tickSteps(1), "the answered program resumes");
+        while (sketch.interpreter->isRunning() && sketch.recorder.lastRequestId.empty() &&
+               sketch.interpreter->tickSteps(1)) {
+        }
+        const auto* level = std::get_if<int32_t>(&sketch.recorder.lastValueSet);
+        TEST_ASSERT(level && *level == reading, "the answer is the value analogRead() returns");
+    }
+
+    TEST_ASSERT(!sketch.interpreter->tickSteps(1000000), "the program completes after its last iteration");
+    TEST_ASSERT_EQ(sketch.interpreter->getLoopIteration(), 3u, "every iteration ran");
+}
+
+// =============================================================================
+// MAIN TEST RUNNER
+// =============================================================================
+
+int main() {
+    std::cout << "=== Execution Control Tests ===" << std::endl;
+    g_tracer.disable();
+
+    int passed = 0;
+    int failed = 0;
+
+    auto result1 = runTest("Blink Is Fast-Forwarded", testBlinkIsFastForwarded);
+    if (result1.success) passed++; else failed++;
+    
+    auto result2 = runTest("Changing State Is Not Fast-Forwarded", testChangingStateIsNotFastForwarded);
+    if (result2.success) passed++; else failed++;
+    
+    auto result3 = runTest("Slice Stops When Budget Is Spent", testSliceStopsWhenBudgetIsSpent);
+    if (result3.success) passed++; else failed++;
+    
+    auto result4 = runTest("Slice Reports Completion", testSliceReportsCompletion);
+    if (result4.success) passed++; else failed++;
+    
+    auto result5 = runTest("Slice Waits On Request", testSliceWaitsOnRequest);
+    if (result5.success) passed++; else failed++;
+
+    std::cout << std::endl;
+    std::cout << "Passed: " << passed << ", Failed: " << failed << std::endl;
+    return failed == 0 ? 0 : 1;
+}
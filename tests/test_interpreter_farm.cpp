@@ -0,0 +1,98 @@
+/**
+ * test_interpreter_farm.cpp - InterpreterFarm instances on worker threads
+ *
+ * Sketches run on the farm's worker threads, each interpreter on its own
+ * evaluator fiber. Fixtures are tests/fixtures/<name>.ast, exported from the
+ * .ino next to them with the JavaScript parser (exportCompactAST).
+ */
+
+#include "test_utils.hpp"
+#include "../src/cpp/InterpreterFarm.hpp"
+#include "../src/cpp/ExecutionTracer.hpp"
+#include <map>
+#include <mutex>
+
+#ifndef TEST_FIXTURE_DIR
+#define TEST_FIXTURE_DIR "../tests/fixtures"
+#endif
+
+using namespace arduino_interpreter;
+using namespace arduino_interpreter::testing;
+
+namespace {
+
+/** Error types reported by each instance */
+struct FarmErrors {
+    std::mutex mutex;
+    std::map<FarmInstanceId, std::vector<std::string>> byInstance;
+
+    void collect(const std::vector<FarmCommand>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& entry : batch) {
+            if (entry.command.getType() == "ERROR") {
+                FlexibleCommandValue errorType = entry.command.get("errorType");
+                const auto* text = std::get_if<std::string>(&errorType);
+                byInstance[entry.instance].push_back(text ? *text : "");
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+// =============================================================================
+// DEEP RECURSION
+// =============================================================================
+
+void testDeepRecursionOnWorkers() {
+    std::vector<uint8_t> compactAST;
+    TEST_ASSERT(loadAST(TEST_FIXTURE_DIR "/deep_recursion.ast", compactAST), "cannot open deep_recursion.ast");
+
+    FarmOptions farmOptions;
+    farmOptions.workerCount = 2;
+    InterpreterFarm farm(farmOptions);
+    FarmErrors errors;
+    farm.setCommandSink([&errors](const std::vector<FarmCommand>& batch) { errors.collect(batch); });
+
+    // The target stack allows a million frames: the evaluator's own stack has to stop the recursion,
+    // whether it is the planned fiber size or an explicitly small one
+    std::vector<FarmInstanceId> ids;
+    for (size_t stackSize : {size_t(0), size_t(128 * 1024), size_t(0), size_t(256 * 1024)}) {
+        InterpreterOptions options;
+        options.maxLoopIterations = 1;
+        options.syncMode = false;
+        options.callStackSize = 256 * 1024 * 1024;
+        options.executionStackSize = stackSize;
+        ids.push_back(farm.addInstance(std::make_unique<ASTInterpreter>(compactAST.data(), compactAST.size(), options)));
+    }
+
+    farm.start();
+    farm.wait();
+    farm.stop();
+
+    TEST_ASSERT_EQ(farm.getStats().instancesCompleted, ids.size(), "every instance completes");
+    for (FarmInstanceId id : ids) {
+        const auto& reported = errors.byInstance[id];
+        TEST_ASSERT(!reported.empty() && reported.front() == "StackOverflowError",
+                    "instance " + std::to_string(id) + " reports a stack overflow");
+    }
+}
+
+// =============================================================================
+// MAIN TEST RUNNER
+// =============================================================================
+
+int main() {
+    std::cout << "=== Interpreter Farm Tests ===" << std::endl;
+    g_tracer.disable();
+
+    int passed = 0;
+    int failed = 0;
+
+    auto result1 = runTest("Deep Recursion On Worker Threads", testDeepRecursionOnWorkers);
+    if (result1.success) passed++; else failed++;
+
+    std::cout << std::endl;
+    std::cout << "Passed: " << passed << ", Failed: " << failed << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+/**
+ * test_language_semantics.cpp - C++ language semantics of the interpreter
+ *
+ * Runs small sketches and checks the values they assign. Sketches are
+ * tests/fixtures/<name>.ast, exported from the .ino next to them with the
+ * JavaScript parser (exportCompactAST); node types the exporter does not
+ * write (C++ casts) are built in memory.
+ */
+
+#include "test_utils.hpp"
+#include "../src/cpp/ExecutionTracer.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+#ifndef TEST_FIXTURE_DIR
+#define TEST_FIXTURE_DIR "../tests/fixtures"
+#endif
+
+using namespace arduino_interpreter;
+using namespace arduino_interpreter::testing;
+
+namespace {
+
+std::string valueText(const FlexibleCommandValue& value) {
+    if (const auto* text = std::get_if<std::string>(&value)) return *text;
+    if (const auto* number = std::get_if<int32_t>(&value)) return std::to_string(*number);
+    if (const auto* number = std::get_if<int64_t>(&value)) return std::to_string(*number);
+    if (const auto* flag = std::get_if<bool>(&value)) return *flag ? "true" : "false";
+    if (const auto* number = std::get_if<double>(&value)) {
+        std::ostringstream out;
+        out << std::setprecision(17) << *number;
+        return out.str();
+    }
+    return "undefined";
+}
+
+/** Last value assigned to each variable, Serial output and errors of one run */
+class SketchRecorder : public FlexibleCommandListener {
+public:
+    std::map<std::string, std::string> variables;
+    std::vector<std::string> printed;
+    std::vector<std::string> errors;
+    std::vector<std::string> commandTypes;
+
+    void onCommand(const FlexibleCommand& command) override {
+        commandTypes.push_back(command.getType());
+        if (command.getType() == "VAR_SET") {
+            variables[valueText(command.get("variable"))] = valueText(command.get("value"));
+        } else if (command.getType() == "FUNCTION_CALL" && command.has("data")) {
+            std::string function = valueText(command.get("function"));
+            if (function == "Serial.print" || function == "Serial.println") {
+                printed.push_back(valueText(command.get("data")));
+            }
+        } else if (command.getType() == "ERROR") {
+            errors.push_back(valueText(command.get("message")));
+        }
+    }
+    void onError(const std::string& error) override { errors.push_back(error); }
+
+    std::string variable(const std::string& name) const {
+        auto found = variables.find(name);
+        return found != variables.end() ? found->second : "<unset>";
+    }
+};
+
+InterpreterOptions sketchOptions(TargetProfile profile) {
+    InterpreterOptions options;
+    options.maxLoopIterations = 1;
+    options.syncMode = true;
+    options.targetProfile = profile;
+    return options;
+}
+
+void runInterpreter(ASTInterpreter& interpreter, SketchRecorder& recorder) {
+    MockResponseHandler responder;
+    interpreter.setCommandListener(&recorder);
+    interpreter.setResponseHandler(&responder);
+    interpreter.start();
+}
+
+/** Run a fixture sketch to completion */
+SketchRecorder runFixture(const std::string& name, const InterpreterOptions& options) {
+    std::vector<uint8_t> compactAST;
+    TEST_ASSERT(loadAST(std::string(TEST_FIXTURE_DIR) + "/" + name + ".ast", compactAST), "cannot open " + name + ".ast");
+    ASTInterpreter interpreter(compactAST.data(), compactAST.size(), options);
+    SketchRecorder recorder;
+    runInterpreter(interpreter, recorder);
+    return recorder;
+}
+
+SketchRecorder runFixture(const std::string& name, TargetProfile profile = TargetProfile::HOST) {
+    return runFixture(name, sketchOptions(profile));
+}
+
+// In-memory AST construction for node types the JavaScript exporter does not write
+
+arduino_ast::ASTNodePtr declaration(const std::string& type, const std::string& name, arduino_ast::ASTNodePtr initializer) {
+    auto declarator = std::make_unique<arduino_ast::DeclaratorNode>(name);
+    declarator->addChild(std::move(initializer));
+    auto varDecl = std::make_unique<arduino_ast::VarDeclNode>();
+    varDecl->setVarType(std::make_unique<arduino_ast::TypeNode>(type));
+    varDecl->addDeclaration(std::move(declarator));
+    return varDecl;
+}
+
+arduino_ast::ASTNodePtr function(const std::string& name, std::vector<arduino_ast::ASTNodePtr> statements) {
+    auto body = std::make_unique<arduino_ast::CompoundStmtNode>();
+    for (auto& statement : statements) {
+        body->addChild(std::move(statement));
+    }
+    auto definition = std::make_unique<arduino_ast::FuncDefNode>();
+    definition->setReturnType(std::make_unique<arduino_ast::TypeNode>("void"));
+    definition->setDeclarator(std::make_unique<arduino_ast::DeclaratorNode>(name));
+    definition->setBody(std::move(body));
+    return definition;
+}
+
+SketchRecorder runProgram(std::vector<arduino_ast::ASTNodePtr> setupStatements, TargetProfile profile = TargetProfile::HOST) {
+    auto program = std::make_unique<arduino_ast::ProgramNode>();
+    program->addChild(function("setup", std::move(setupStatements)));
+    program->addChild(function("loop", {}));
+    ASTInterpreter interpreter(std::move(program), sketchOptions(profile));
+    SketchRecorder recorder;
+    runInterpreter(interpreter, recorder);
+    return recorder;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// CASTS
+// =============================================================================
+
+void testCastExpressions() {
+    for (TargetProfile profile : {TargetProfile::HOST, TargetProfile::AVR8}) {
+        std::vector<arduino_ast::ASTNodePtr> statements;
+
+        // int x = int(3.7);
+        auto functionCast = std::make_unique<arduino_ast::FunctionStyleCastNode>();
+        functionCast->setCastType(std::make_unique<arduino_ast::TypeNode>("int"));
+        functionCast->setArgument(std::make_unique<arduino_ast::NumberNode>(3.7));
+        statements.push_back(declaration("int", "x", std::move(functionCast)));
+
+        // float y = static_cast<int>(5.5);
+        auto staticCast = std::make_unique<arduino_ast::CppCastNode>();
+        staticCast->setCastType("static_cast");
+        staticCast->setTargetType(std::make_unique<arduino_ast::TypeNode>("int"));
+        staticCast->setExpression(std::make_unique<arduino_ast::NumberNode>(5.5));
+        statements.push_back(declaration("float", "y", std::move(staticCast)));
+
+        // int mask = int(4294967295.0);  (an all-ones unsigned long, held as double)
+        auto maskCast = std::make_unique<arduino_ast::FunctionStyleCastNode>();
+        maskCast->setCastType(std::make_unique<arduino_ast::TypeNode>("int"));
+        maskCast->setArgument(std::make_unique<arduino_ast::NumberNode>(4294967295.0));
+        statements.push_back(declaration("int", "mask", std::move(maskCast)));
+
+        SketchRecorder recorder = runProgram(std::move(statements), profile);
+        TEST_ASSERT(recorder.errors.empty(), "cast sketch reported an error");
+        TEST_ASSERT_EQ(recorder.variable("x"), std::string("3"), "int(3.7)");
+        TEST_ASSERT_EQ(recorder.variable("y"), std::string("5"), "static_cast<int>(5.5) stored in a float");
+        TEST_ASSERT_EQ(recorder.variable("mask"), std::string("-1"), "int(0xFFFFFFFFUL) keeps the bit pattern");
+    }
+}
+
+// =============================================================================
+// TARGET ARITHMETIC
+// =============================================================================
+
+void testIntegerArithmetic() {
+    for (TargetProfile profile : {TargetProfile::AVR8, TargetProfile::ESP32}) {
+        SketchRecorder recorder = runFixture("integer_arithmetic", profile);
+        std::string target = targetProfileName(profile);
+        TEST_ASSERT(recorder.errors.empty(), target + ": sketch reported an error");
+        TEST_ASSERT_EQ(recorder.variable("quotient"), std::string("3"), target + ": 7 / 2 is integer division");
+        TEST_ASSERT_EQ(recorder.variable("wrapped"), std::string(profile == TargetProfile::AVR8 ? "-32768" : "32768"),
+                       target + ": 32767 + 1 in int");
+        TEST_ASSERT_EQ(recorder.variable("now"), std::string("0"), target + ": unsigned long wraps to 0");
+        TEST_ASSERT_EQ(recorder.variable("elapsed"), std::string("1"), target + ": elapsed time across the wrap");
+        TEST_ASSERT_EQ(recorder.variable("third"), valueText(static_cast<double>(1.0f / 3.0f)),
+                       target + ": float keeps float precision");
+    }
+}
+
+// =============================================================================
+// USER FUNCTIONS
+// =============================================================================
+
+void testUserFunctionCalls() {
+    // Pre-resolved (preresolveParameters) and definition-walking calls bind and check arguments the same way
+    for (bool planned : {false, true}) {
+        InterpreterOptions options = sketchOptions(TargetProfile::AVR8);
+        options.preresolveParameters = planned;
+        SketchRecorder recorder = runFixture("user_functions", options);
+        std::string mode = planned ? "planned" : "unplanned";
+        TEST_ASSERT_EQ(recorder.variable("total"), std::string("10"), mode + ": add(2, 3) * 2");
+        TEST_ASSERT_EQ(recorder.variable("scaled"), std::string("12"), mode + ": scale(4) takes the default factor");
+        TEST_ASSERT(!recorder.errors.empty(), mode + ": add(1, 2, 3) reports an error");
+        for (const auto& error : recorder.errors) {
+            TEST_ASSERT_EQ(error, std::string("Function add expects 2-2 arguments, got 3"), mode + ": arity error");
+        }
+    }
+}
+
+void testPureFunctionCache() {
+    // The cache answers repeated CRCs (directly and from checksum) without changing what the sketch sees
+    std::vector<uint8_t> compactAST;
+    TEST_ASSERT(loadAST(TEST_FIXTURE_DIR "/pure_crc.ast", compactAST), "cannot open pure_crc.ast");
+    std::vector<std::string> commandTypes[2];
+    for (bool memoize : {false, true}) {
+        InterpreterOptions options = sketchOptions(TargetProfile::AVR8);
+        options.maxLoopIterations = 8;  // Also bounds the for loops in crc8
+        options.memoizePureFunctions = memoize;
+        ASTInterpreter interpreter(compactAST.data(), compactAST.size(), options);
+        SketchRecorder recorder;
+        runInterpreter(interpreter, recorder);
+        std::string mode = memoize ? "memoized" : "not memoized";
+        TEST_ASSERT(recorder.errors.empty(), mode + ": sketch reported an error");
+        TEST_ASSERT_EQ(recorder.variable("first"), std::string("8"), mode + ": crc8(0x12345678)");
+        TEST_ASSERT_EQ(recorder.variable("again"), std::string("8"), mode + ": crc8(0x12345678) again");
+        TEST_ASSERT_EQ(recorder.variable("other"), std::string("82"), mode + ": crc8(42)");
+        TEST_ASSERT_EQ(recorder.variable("mixed"), std::string("90"), mode + ": checksum calls crc8");
+        TEST_ASSERT_EQ(interpreter.getFunctionCallStats().pureCacheHits, memoize ? 3u : 0u, mode + ": cached calls");
+        commandTypes[memoize] = recorder.commandTypes;
+    }
+    TEST_ASSERT(commandTypes[0] == commandTypes[1], "cached calls replay the commands of the body");
+}
+
+// =============================================================================
+// STRINGS
+// =============================================================================
+
+void testStringFormatting() {
+    for (TargetProfile profile : {TargetProfile::HOST, TargetProfile::AVR8}) {
+        SketchRecorder recorder = runFixture("string_formatting", profile);
+        std::string target = targetProfileName(profile);
+        TEST_ASSERT(recorder.errors.empty(), target + ": sketch reported an error");
+        TEST_ASSERT_EQ(recorder.variable("fromFloat"), std::string("1.50"), target + ": String(1.5) has two decimals");
+        TEST_ASSERT_EQ(recorder.variable("fromLiteral"), std::string("42"), target + ": String(42) is an integer");
+        TEST_ASSERT_EQ(recorder.variable("appended"), std::string("n=5A0.25"), target + ": += int literal, char, float");
+        TEST_ASSERT_EQ(recorder.variable("joined"), std::string("x7A"), target + ": + chain ending in a char");
+        TEST_ASSERT_EQ(recorder.variable("piece"), std::string("bc1"), target + ": untyped String operand concatenates");
+    }
+}
+
+// =============================================================================
+// SWITCH
+// =============================================================================
+
+void testSwitchDispatch() {
+    // traceSwitchCases adds the JavaScript stream's reports of the cases passed over
+    for (bool traced : {false, true}) {
+        InterpreterOptions options = sketchOptions(TargetProfile::HOST);
+        options.traceSwitchCases = traced;
+        SketchRecorder recorder = runFixture("switch_dispatch", options);
+        std::string mode = traced ? "traced" : "untraced";
+        TEST_ASSERT(recorder.errors.empty(), mode + ": sketch reported an error");
+        TEST_ASSERT_EQ(recorder.variable("picked"), std::string("30"), mode + ": jumps to case 3");
+        TEST_ASSERT_EQ(recorder.variable("fallen"), std::string("6"), mode + ": falls through to the break");
+        TEST_ASSERT_EQ(recorder.variable("other"), std::string("-1"), mode + ": no label matches, default runs");
+        size_t switchCases = std::count(recorder.commandTypes.begin(), recorder.commandTypes.end(), "SWITCH_CASE");
+        TEST_ASSERT_EQ(switchCases, traced ? 7u : 3u, mode + ": SWITCH_CASE commands");
+    }
+}
+
+// =============================================================================
+// MAIN TEST RUNNER
+// =============================================================================
+
+int main() {
+    std::cout << "=== Language Semantics Tests ===" << std::endl;
+    g_tracer.disable();
+
+    int passed = 0;
+    int failed = 0;
+
+    auto result1 = runTest("Cast Expressions", testCastExpressions);
+    if (result1.success) passed++; else failed++;
+    
+    auto result2 = runTest("Integer Arithmetic", testIntegerArithmetic);
+    if (result2.success) passed++; else failed++;
+    
+    auto result3 = runTest("User Function Calls", testUserFunctionCalls);
+    if (result3.success) passed++; else failed++;
+    
+    auto result4 = runTest("Pure Function Cache", testPureFunctionCache);
+    if (result4.success) passed++; else failed++;
+    
+    auto result5 = runTest("String Formatting", testStringFormatting);
+    if (result5.success) passed++; else failed++;
+    
+    auto result6 = runTest("Switch Dispatch", testSwitchDispatch);
+    if (result6.success) passed++; else failed++;
+
+    std::cout << std::endl;
+    std::cout << "Passed: " << passed << ", Failed: " << failed << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -16,6 +16,7 @@
 #include "../libs/CompactAST/src/CompactAST.hpp"
 #include <vector>
 #include <string>
+#include <fstream>
 #include <memory>
 #include <iostream>
 #include <thread>
@@ -240,6 +241,19 @@ TestResult executeWithTimeout(ASTInterpreter& interpreter, uint32_t timeoutMs =
 // AST HELPERS
 // =============================================================================
 
+/**
+ * Read a compact AST file (e.g. a tests/fixtures/<name>.ast export)
+ */
+bool loadAST(const std::string& fileName, std::vector<uint8_t>& compactAST) {
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    compactAST.resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(compactAST.data()), size);
+    return true;
+}
+
 /**
  * Create test AST from compact binary data
  */
@@ -249,6 +263,7 @@ std::unique_ptr<ASTInterpreter> createInterpreterFromBinary(const uint8_t* data,
     options.debug = false;
     options.maxLoopIterations = 1; // MATCH JAVASCRIPT: Use exactly 1 iteration like JS test data
     options.syncMode = true; // TEST MODE: Enable synchronous responses for digitalRead/analogRead
+    options.traceSwitchCases = true; // MATCH JAVASCRIPT: Report the cases tested before the match
     
     return std::make_unique<ASTInterpreter>(data, size, options);
 }